@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts global operator new calls made by any thread in the benchmark
+// binary. The replacement allocation functions live in AllocationCounter.cpp.
+std::uint64_t allocationCount();
@@ -0,0 +1,102 @@
+#include "BenchRunner.hpp"
+#include "AllocationCounter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+BenchRunner::BenchRunner(BenchOptions options) : options_(std::move(options)) {}
+
+double BenchResult::percentile(double p) const {
+    if (ns_per_op.empty()) return 0.0;
+    double rank = p / 100.0 * static_cast<double>(ns_per_op.size() - 1);
+    auto lower = static_cast<std::size_t>(std::floor(rank));
+    auto upper = std::min(lower + 1, ns_per_op.size() - 1);
+    double frac = rank - static_cast<double>(lower);
+    return ns_per_op[lower] + (ns_per_op[upper] - ns_per_op[lower]) * frac;
+}
+
+bool BenchRunner::enabled(const std::string &name) const {
+    return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+}
+
+void BenchRunner::run(const std::string &name, std::size_t ops, const Body &body) {
+    if (!enabled(name) || ops == 0) return;
+
+    for (std::size_t i = 0; i < options_.warmup; ++i) {
+        body(ops);
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.ops_per_sample = ops;
+    std::uint64_t allocations = 0;
+    for (std::size_t i = 0; i < options_.repetitions; ++i) {
+        std::uint64_t before = allocationCount();
+        auto start = std::chrono::steady_clock::now();
+        body(ops);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        allocations += allocationCount() - before;
+        result.ns_per_op.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(ops));
+    }
+    std::sort(result.ns_per_op.begin(), result.ns_per_op.end());
+    result.allocations_per_op =
+        static_cast<double>(allocations) / static_cast<double>(ops * std::max<std::size_t>(options_.repetitions, 1));
+    results_.push_back(std::move(result));
+}
+
+void BenchRunner::check(const std::string &name, bool passed) {
+    if (!enabled(name)) return;
+    checks_.emplace_back(name, passed);
+}
+
+bool BenchRunner::allChecksPassed() const {
+    return std::all_of(checks_.begin(), checks_.end(), [](const auto &check) { return check.second; });
+}
+
+const std::vector<BenchResult> &BenchRunner::results() const { return results_; }
+
+void BenchRunner::printTable(std::ostream &out) const {
+    const int name_w = 44;
+    out << std::left << std::setw(name_w) << "Benchmark" << std::right << std::setw(12) << "ns/op p50"
+        << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(14) << "ops/s p50" << std::setw(14)
+        << "ops/s p99" << std::setw(12) << "allocs/op" << "\n";
+    out << std::string(name_w + 12 * 4 + 14 * 2, '-') << "\n";
+    for (const auto &result : results_) {
+        double p50 = result.percentile(50);
+        double p99 = result.percentile(99);
+        out << std::left << std::setw(name_w) << result.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << p50 << std::setw(12) << result.percentile(90) << std::setw(12) << p99
+            << std::setprecision(0) << std::setw(14) << (p50 > 0 ? 1e9 / p50 : 0.0) << std::setw(14)
+            << (p99 > 0 ? 1e9 / p99 : 0.0) << std::setprecision(3) << std::setw(12) << result.allocations_per_op
+            << "\n";
+    }
+    for (const auto &[name, passed] : checks_) {
+        out << std::left << std::setw(name_w) << name << (passed ? "PASS" : "FAIL") << "\n";
+    }
+}
+
+void BenchRunner::writeJson(std::ostream &out) const {
+    // Throughput percentiles are taken over per-sample throughput, so the
+    // p99 entry corresponds to the p99 (slowest) ns/op sample.
+    out << std::setprecision(6) << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results_.size(); ++i) {
+        const auto &r = results_[i];
+        double p50 = r.percentile(50);
+        double p90 = r.percentile(90);
+        double p99 = r.percentile(99);
+        out << "    {\"name\": \"" << r.name << "\", \"ops_per_sample\": " << r.ops_per_sample
+            << ", \"samples\": " << r.ns_per_op.size() << ", \"ns_per_op\": {\"min\": " << r.ns_per_op.front()
+            << ", \"p50\": " << p50 << ", \"p90\": " << p90 << ", \"p99\": " << p99 << ", \"max\": " << r.ns_per_op.back()
+            << "}, \"ops_per_sec\": {\"p50\": " << (p50 > 0 ? 1e9 / p50 : 0.0) << ", \"p90\": "
+            << (p90 > 0 ? 1e9 / p90 : 0.0) << ", \"p99\": " << (p99 > 0 ? 1e9 / p99 : 0.0)
+            << "}, \"allocations_per_op\": " << r.allocations_per_op << "}" << (i + 1 < results_.size() ? "," : "")
+            << "\n";
+    }
+    out << "  ],\n  \"checks\": [\n";
+    for (std::size_t i = 0; i < checks_.size(); ++i) {
+        out << "    {\"name\": \"" << checks_[i].first << "\", \"passed\": " << (checks_[i].second ? "true" : "false")
+            << "}" << (i + 1 < checks_.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BenchOptions {
+    std::string filter;          // run only benchmarks whose name contains this
+    std::size_t repetitions{15}; // timed samples per benchmark
+    std::size_t warmup{2};       // untimed samples per benchmark
+};
+
+struct BenchResult {
+    std::string name;
+    std::size_t ops_per_sample{};
+    std::vector<double> ns_per_op; // one entry per timed sample, sorted
+    double allocations_per_op{};
+
+    double percentile(double p) const;
+};
+
+// Runs each benchmark body `warmup + repetitions` times. A body performs
+// `ops` operations per call; per-sample wall time and the global allocation
+// count are divided by `ops` to give ns/op and allocations/op.
+class BenchRunner {
+public:
+    using Body = std::function<void(std::size_t ops)>;
+
+    explicit BenchRunner(BenchOptions options);
+
+    bool enabled(const std::string &name) const;
+    void run(const std::string &name, std::size_t ops, const Body &body);
+
+    // Records a pass/fail consistency check alongside the timings.
+    void check(const std::string &name, bool passed);
+    bool allChecksPassed() const;
+
+    const std::vector<BenchResult> &results() const;
+    void printTable(std::ostream &out) const;
+    void writeJson(std::ostream &out) const;
+
+private:
+    BenchOptions options_;
+    std::vector<BenchResult> results_;
+    std::vector<std::pair<std::string, bool>> checks_;
+};
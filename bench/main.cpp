@@ -0,0 +1,857 @@
+#include "AllocationCounter.hpp"
+#include "BenchRunner.hpp"
+#include "DoubleBuffer.hpp"
+#include "Storage.hpp"
+#include "TableRenderer.hpp"
+#include "quantis/anomaly/AnomalyEngine.hpp"
+#include "quantis/anomaly/AnomalySnapshot.hpp"
+#include "quantis/anomaly/ShardedAnomalyEngine.hpp"
+#include "quantis/anomaly/StatsBuffer.hpp"
+#include "quantis/daemon/DaemonClient.hpp"
+#include "quantis/daemon/DaemonServer.hpp"
+#include "quantis/feed/FeedClient.hpp"
+#include "quantis/feed/FeedServer.hpp"
+#include "quantis/feed/QuoteMessage.hpp"
+#include "quantis/filter/FilterExpression.hpp"
+#include "quantis/metrics/MetricsServer.hpp"
+#include "quantis/metrics/StageMetrics.hpp"
+#include "quantis/sim/MarketSimulator.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+// Swallows everything written to it; used as std::cout's buffer while the
+// renderer benchmarks run.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+class CoutSilencer {
+public:
+    CoutSilencer() : previous_(std::cout.rdbuf(&null_)) {}
+    ~CoutSilencer() { std::cout.rdbuf(previous_); }
+
+private:
+    NullBuffer null_;
+    std::streambuf *previous_;
+};
+
+template <typename T>
+void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Deterministic random-walk universe: `ticks` consecutive quote snapshots
+// for `tickers` symbols, with occasional jumps so every rule fires.
+class SyntheticMarket {
+public:
+    SyntheticMarket(std::size_t tickers, std::size_t ticks, unsigned seed = 42) : tickers_(tickers) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::vector<double> price(tickers);
+        for (auto &p : price) p = 10.0 + unit(rng) * 490.0;
+
+        quotes_.resize(ticks * tickers);
+        for (std::size_t t = 0; t < ticks; ++t) {
+            for (std::size_t i = 0; i < tickers; ++i) {
+                double shock = unit(rng) < 0.02 ? (unit(rng) - 0.5) * 0.2 : (unit(rng) - 0.5) * 0.01;
+                price[i] *= 1.0 + shock;
+                double spread = unit(rng) < 0.05 ? unit(rng) * 2.0 : 0.01 + unit(rng) * 0.1;
+                Quote &q = quotes_[t * tickers + i];
+                q.price = price[i];
+                q.market_cap = 1e9 + unit(rng) * 1e12;
+                q.daily_percent_change = (unit(rng) - 0.5) * 10.0;
+                q.volume = static_cast<long long>(unit(rng) * 5e7);
+                q.average_volume = static_cast<long long>(1e6 + unit(rng) * 2e7);
+                q.fiftytwo_week_high = price[i] * (0.99 + unit(rng) * 0.2);
+                q.fiftytwo_week_low = price[i] * (0.8 + unit(rng) * 0.21);
+                q.bid = price[i] - spread / 2;
+                q.ask = price[i] + spread / 2;
+            }
+        }
+        ids_.resize(tickers);
+        for (std::size_t i = 0; i < tickers; ++i) ids_[i] = static_cast<TickerId>(i);
+    }
+
+    std::size_t tickers() const { return tickers_; }
+    std::size_t ticks() const { return quotes_.size() / tickers_; }
+    std::span<const Quote> tick(std::size_t t) const {
+        return std::span<const Quote>(quotes_).subspan((t % ticks()) * tickers_, tickers_);
+    }
+    std::span<const TickerId> ids() const { return ids_; }
+
+private:
+    std::size_t tickers_;
+    std::vector<Quote> quotes_;
+    std::vector<TickerId> ids_;
+};
+
+ScreenerRows makeRows(const SyntheticMarket &market, std::size_t tick) {
+    auto quotes = market.tick(tick);
+    auto tickers = std::make_shared<std::vector<TickerRecord>>();
+    tickers->reserve(quotes.size());
+    for (std::size_t i = 0; i < quotes.size(); ++i) {
+        TickerRecord record;
+        record.id = static_cast<TickerId>(i);
+        record.ticker = "T" + std::to_string(i);
+        record.name = "Synthetic " + std::to_string(i);
+        record.sector = "Tech";
+        record.notes = i % 7 == 0 ? "watch \"closely\", maybe" : "";
+        record.date_added = "2024-01-01 00:00:00";
+        tickers->push_back(std::move(record));
+    }
+    ScreenerRows rows;
+    rows.reserve(quotes.size());
+    for (std::size_t i = 0; i < quotes.size(); ++i) {
+        rows.emplace_back(&(*tickers)[i], quotes[i]);
+    }
+    rows.tickers = std::move(tickers);
+    return rows;
+}
+
+std::size_t ticksFor(std::size_t universe) { return universe >= 1000000 ? 2 : universe >= 100000 ? 4 : 8; }
+
+void benchStatsBuffer(BenchRunner &runner) {
+    SyntheticMarket market(1, 4096);
+    std::size_t cursor = 0;
+
+    StatsBuffer buffer;
+    runner.run("stats_buffer/add_sample", 1000000, [&](std::size_t ops) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            buffer.addSample(market.tick(cursor++)[0]);
+        }
+        doNotOptimize(buffer.size());
+    });
+
+    runner.run("stats_buffer/add_sample+statistics", 1000000, [&](std::size_t ops) {
+        double sink = 0.0;
+        for (std::size_t i = 0; i < ops; ++i) {
+            buffer.addSample(market.tick(cursor++)[0]);
+            sink += buffer.priceReturn() + buffer.recentVolatility() + buffer.meanSpread() + buffer.shortTermSlope() +
+                    buffer.longTermSlope();
+        }
+        doNotOptimize(sink);
+    });
+}
+
+void benchAnomaly(BenchRunner &runner, std::size_t max_universe) {
+    for (std::size_t universe = 1000; universe <= max_universe; universe *= 10) {
+        std::string suffix = "/" + std::to_string(universe);
+        bool wanted = runner.enabled("anomaly/evaluate" + suffix) || runner.enabled("anomaly/evaluate_batch");
+        if (!wanted) continue;
+
+        SyntheticMarket market(universe, ticksFor(universe));
+        std::size_t tick = 0;
+
+        {
+            AnomalyEngine engine;
+            engine.ensureTickers(universe);
+            runner.run("anomaly/evaluate" + suffix, universe, [&](std::size_t) {
+                auto quotes = market.tick(tick++);
+                AlertSet any = 0;
+                for (std::size_t i = 0; i < quotes.size(); ++i) {
+                    any |= engine.evaluate(static_cast<TickerId>(i), quotes[i]);
+                }
+                doNotOptimize(any);
+            });
+        }
+
+        std::vector<AlertSet> out(universe);
+        for (auto [kernel, label] : {std::pair{RuleKernel::Scalar, "scalar"}, std::pair{RuleKernel::Avx2, "avx2"}}) {
+            if (!ruleKernelAvailable(kernel)) continue;
+            AnomalyEngine engine;
+            engine.ensureTickers(universe);
+            runner.run(std::string("anomaly/evaluate_batch/") + label + suffix, universe, [&](std::size_t) {
+                engine.evaluateBatch(market.ids(), market.tick(tick++), out, kernel);
+                doNotOptimize(out.data());
+            });
+        }
+    }
+
+    // Batch output must match evaluate() bit for bit, whatever the kernel.
+    // Each tick goes in as a few calls of odd sizes (shorter than a vector,
+    // then the rest with a scalar tail) over shuffled ids, and every rule
+    // has to fire at least once so no kernel path goes untested.
+    std::string check_name = "anomaly/evaluate_batch/bit_identical";
+    if (!runner.enabled(check_name)) return;
+    SyntheticMarket market(1003, 200, 7);
+    std::vector<TickerId> order(market.ids().begin(), market.ids().end());
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    std::vector<RuleKernel> kernels{RuleKernel::Scalar, RuleKernel::Auto};
+    if (ruleKernelAvailable(RuleKernel::Avx2)) kernels.push_back(RuleKernel::Avx2);
+    AnomalyEngine reference;
+    std::vector<AnomalyEngine> engines(kernels.size());
+    std::vector<Quote> quotes(order.size());
+    std::vector<AlertSet> expected(order.size());
+    std::vector<AlertSet> actual(order.size());
+    AlertSet fired = 0;
+    bool identical = true;
+    for (std::size_t t = 0; t < market.ticks(); ++t) {
+        auto tick = market.tick(t);
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            quotes[i] = tick[order[i]];
+            expected[i] = reference.evaluate(order[i], quotes[i]);
+            fired |= expected[i];
+        }
+        for (std::size_t k = 0; k < kernels.size(); ++k) {
+            std::size_t begin = 0;
+            for (std::size_t size : {std::size_t{1}, std::size_t{3}, std::size_t{5}, order.size()}) {
+                std::size_t end = std::min(begin + size, order.size());
+                engines[k].evaluateBatch(std::span<const TickerId>(order).subspan(begin, end - begin),
+                                         std::span<const Quote>(quotes).subspan(begin, end - begin),
+                                         std::span<AlertSet>(actual).subspan(begin, end - begin), kernels[k]);
+                begin = end;
+            }
+            identical = identical && actual == expected;
+        }
+    }
+    runner.check(check_name, identical && fired == (AlertSet{1} << kAlertCount) - 1);
+}
+
+void benchShardedAnomaly(BenchRunner &runner, std::size_t max_universe) {
+    std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t universe = 1000; universe <= max_universe; universe *= 10) {
+        for (std::size_t shards = 1;; shards = std::min(shards * 2, cores)) {
+            std::string name =
+                "anomaly/evaluate_sharded/" + std::to_string(shards) + "_shards/" + std::to_string(universe);
+            if (runner.enabled(name)) {
+                SyntheticMarket market(universe, ticksFor(universe));
+                std::size_t tick = 0;
+                ShardedAnomalyEngine engine(shards);
+                std::vector<AlertSet> out(universe);
+                runner.run(name, universe, [&](std::size_t) {
+                    engine.evaluate(market.ids(), market.tick(tick++), out);
+                    doNotOptimize(out.data());
+                });
+            }
+            if (shards == cores) break;
+        }
+    }
+
+    // Sharding must not change results, including across a clear() and a
+    // change in which tickers are evaluated.
+    std::string check_name = "anomaly/evaluate_sharded/matches_batch";
+    if (!runner.enabled(check_name)) return;
+    SyntheticMarket market(1003, 200, 11);
+    AnomalyEngine reference;
+    ShardedAnomalyEngine sharded(4);
+    std::vector<TickerId> ids(market.ids().begin(), market.ids().end());
+    std::vector<AlertSet> expected(ids.size());
+    std::vector<AlertSet> actual(ids.size());
+    bool identical = true;
+    for (std::size_t t = 0; t < market.ticks(); ++t) {
+        if (t == 80) {
+            reference.clear();
+            sharded.clear();
+        }
+        if (t == 120) {
+            std::reverse(ids.begin(), ids.end());
+            ids.resize(ids.size() / 2);
+        }
+        auto all = market.tick(t);
+        std::vector<Quote> quotes;
+        for (TickerId id : ids) quotes.push_back(all[id]);
+        reference.evaluateBatch(ids, quotes, expected);
+        sharded.evaluate(ids, quotes, actual);
+        identical = identical && std::equal(expected.begin(), expected.begin() + ids.size(), actual.begin());
+    }
+    runner.check(check_name, identical);
+}
+
+void benchAnomalySnapshot(BenchRunner &runner, const std::filesystem::path &dir, std::size_t max_universe) {
+    std::string path = (dir / "anomaly.bin").string();
+    auto symbolOf = [](const std::vector<std::string> &names) {
+        return [&names](TickerId id) { return id < names.size() ? std::string_view(names[id]) : std::string_view(); };
+    };
+    auto idOf = [](std::string_view symbol) {
+        return symbol.size() > 1 ? static_cast<TickerId>(std::stoul(std::string(symbol.substr(1))))
+                                 : SymbolTable::kInvalidId;
+    };
+
+    // Checkpoint and warm start of a universe with full windows; ns/op is
+    // per ticker. Capture is the part a checkpoint costs the evaluating
+    // thread; save adds the write and sync done in the background.
+    std::string capture_name = "anomaly/snapshot_capture/" + std::to_string(max_universe);
+    std::string save_name = "anomaly/snapshot_save/" + std::to_string(max_universe);
+    std::string restore_name = "anomaly/snapshot_restore/" + std::to_string(max_universe);
+    if (runner.enabled(capture_name) || runner.enabled(save_name) || runner.enabled(restore_name)) {
+        SyntheticMarket market(max_universe, ticksFor(max_universe));
+        std::vector<std::string> names(max_universe);
+        for (std::size_t i = 0; i < max_universe; ++i) names[i] = "T" + std::to_string(i);
+        ShardedAnomalyEngine engine(1);
+        std::vector<AlertSet> out(max_universe);
+        for (std::size_t t = 0; t < StatsBuffer::kDefaultCapacity; ++t) {
+            engine.evaluate(market.ids(), market.tick(t), out);
+        }
+        bool ok = anomaly_snapshot::save(path, engine, symbolOf(names));
+        if (runner.enabled(capture_name)) {
+            std::string image;
+            runner.run(capture_name, max_universe,
+                       [&](std::size_t) { anomaly_snapshot::capture(engine, symbolOf(names), image); });
+        }
+        if (runner.enabled(save_name)) {
+            runner.run(save_name, max_universe,
+                       [&](std::size_t) { ok = anomaly_snapshot::save(path, engine, symbolOf(names)) && ok; });
+        }
+        if (runner.enabled(restore_name)) {
+            ShardedAnomalyEngine restored(1);
+            runner.run(restore_name, max_universe, [&](std::size_t) {
+                auto result = anomaly_snapshot::restore(path, restored, idOf, std::chrono::hours(1));
+                ok = ok && result && result->tickers == max_universe;
+            });
+        }
+        if (!ok) throw std::runtime_error("anomaly snapshot round trip failed");
+    }
+
+    // A restart from a snapshot raises exactly the alerts an uninterrupted
+    // engine would, whatever the shard counts on either side.
+    std::string check_name = "anomaly/snapshot_restore/matches_uninterrupted";
+    if (!runner.enabled(check_name)) return;
+    SyntheticMarket market(1003, 200, 13);
+    std::vector<std::string> names(market.tickers());
+    for (std::size_t i = 0; i < names.size(); ++i) names[i] = "T" + std::to_string(i);
+    ShardedAnomalyEngine reference(4);
+    ShardedAnomalyEngine before(3);
+    std::vector<AlertSet> expected(market.tickers());
+    std::vector<AlertSet> actual(market.tickers());
+    for (std::size_t t = 0; t < 110; ++t) {
+        reference.evaluate(market.ids(), market.tick(t), expected);
+        before.evaluate(market.ids(), market.tick(t), actual);
+    }
+    ShardedAnomalyEngine after(2);
+    auto result = anomaly_snapshot::save(path, before, symbolOf(names))
+                      ? anomaly_snapshot::restore(path, after, idOf, std::chrono::hours(1))
+                      : std::nullopt;
+    bool identical = result && result->tickers == market.tickers();
+    for (std::size_t t = 110; t < market.ticks(); ++t) {
+        reference.evaluate(market.ids(), market.tick(t), expected);
+        after.evaluate(market.ids(), market.tick(t), actual);
+        identical = identical && expected == actual;
+    }
+    runner.check(check_name, identical);
+}
+
+void benchRenderer(BenchRunner &runner) {
+    SyntheticMarket market(1000, 2);
+    auto rows = makeRows(market, 0);
+    AnomalyEngine engine;
+    std::vector<AlertSet> alerts(rows.size());
+    engine.evaluateBatch(market.ids(), market.tick(0), alerts);
+    engine.evaluateBatch(market.ids(), market.tick(1), alerts);
+
+    TableRenderer renderer;
+    CoutSilencer silence;
+    runner.run("renderer/render/1000_rows", 10, [&](std::size_t frames) {
+        for (std::size_t f = 0; f < frames; ++f) renderer.render(rows);
+    });
+    runner.run("renderer/render_with_alerts/1000_rows", 10, [&](std::size_t frames) {
+        for (std::size_t f = 0; f < frames; ++f) renderer.renderWithAlerts(rows, alerts, false);
+    });
+    runner.run("renderer/format_with_alerts/1000_rows", 10, [&](std::size_t frames) {
+        for (std::size_t f = 0; f < frames; ++f) doNotOptimize(renderer.formatWithAlerts(rows, alerts, false));
+    });
+
+    // Once the frame buffer has grown to size, no layout touches the heap.
+    // Grow it first in case the timed runs above were filtered out.
+    doNotOptimize(renderer.formatWithAlerts(rows, alerts, false));
+    auto before = allocationCount();
+    for (std::size_t f = 0; f < 10; ++f) {
+        doNotOptimize(renderer.format(rows));
+        doNotOptimize(renderer.formatWithAlerts(rows, alerts, false));
+        doNotOptimize(renderer.formatWithAlerts(rows, alerts, true));
+    }
+    runner.check("renderer/zero_allocations_per_frame", allocationCount() == before);
+}
+
+void checkFilter(BenchRunner &runner) {
+    // Compiled filters select exactly the rows a direct C++ predicate does,
+    // across immediate operands, deep nesting (scratch rows reused at each
+    // depth), nested '!' and text comparisons, over a partial last batch.
+    std::string check_name = "filter/select/matches_reference";
+    if (!runner.enabled(check_name)) return;
+    using Predicate = std::function<bool(const TickerRecord &, const Quote &)>;
+    const std::vector<std::pair<const char *, Predicate>> cases = {
+        {"price > 20 && daily_percent_change < -3 && volume > 2 * average_volume",
+         [](const TickerRecord &, const Quote &q) {
+             return q.price > 20 && q.daily_percent_change < -3 &&
+                    static_cast<double>(q.volume) > 2 * static_cast<double>(q.average_volume);
+         }},
+        {"(ask - bid) * 100 / price > 0.5 || -daily_percent_change >= 4",
+         [](const TickerRecord &, const Quote &q) {
+             return (q.ask - q.bid) * 100 / q.price > 0.5 || -q.daily_percent_change >= 4;
+         }},
+        {"((price + 1) * (bid + 2) - (ask - 3) * (market_cap / 1000000000)) / "
+         "((fiftytwo_week_high - fiftytwo_week_low) + 1) > 50",
+         [](const TickerRecord &, const Quote &q) {
+             return ((q.price + 1) * (q.bid + 2) - (q.ask - 3) * (q.market_cap / 1000000000)) /
+                        ((q.fiftytwo_week_high - q.fiftytwo_week_low) + 1) >
+                    50;
+         }},
+        {"!(!(price < 200) || !(volume <= average_volume))",
+         [](const TickerRecord &, const Quote &q) {
+             return !(!(q.price < 200) || !(static_cast<double>(q.volume) <= static_cast<double>(q.average_volume)));
+         }},
+        {"(notes != \"\" || ticker == \"T3\") && !(name == \"Synthetic 14\") && sector == \"Tech\" || price < 15",
+         [](const TickerRecord &r, const Quote &q) {
+             return ((!r.notes.empty() || r.ticker == "T3") && !(r.name == "Synthetic 14") && r.sector == "Tech") ||
+                    q.price < 15;
+         }},
+    };
+
+    SyntheticMarket market(1003, 1, 17);
+    auto rows = makeRows(market, 0);
+    QuoteColumns columns;
+    columns.load(rows);
+    std::vector<std::uint32_t> selection;
+    std::vector<std::uint32_t> expected;
+    bool identical = true;
+    for (const auto &[text, predicate] : cases) {
+        FilterExpression::compile(text).select(columns, selection);
+        expected.clear();
+        for (std::uint32_t i = 0; i < rows.size(); ++i) {
+            if (predicate(*rows[i].first, rows[i].second)) expected.push_back(i);
+        }
+        identical = identical && selection == expected;
+    }
+    runner.check(check_name, identical);
+}
+
+void benchFilter(BenchRunner &runner, std::size_t max_universe) {
+    checkFilter(runner);
+    std::size_t universe = std::min<std::size_t>(100000, max_universe);
+    std::string suffix = "/" + std::to_string(universe);
+    bool wanted = runner.enabled("filter/load_columns" + suffix) || runner.enabled("filter/select_numeric" + suffix) ||
+                  runner.enabled("filter/select_text" + suffix);
+    if (!wanted) return;
+
+    SyntheticMarket market(universe, 1);
+    auto rows = makeRows(market, 0);
+    QuoteColumns columns;
+    columns.load(rows);
+    runner.run("filter/load_columns" + suffix, universe, [&](std::size_t) { columns.load(rows); });
+
+    auto numeric = FilterExpression::compile("price > 20 && daily_percent_change < -3 && volume > 2 * average_volume");
+    auto text = FilterExpression::compile("sector == \"Tech\" && ticker != \"T1\"");
+    std::vector<std::uint32_t> selection;
+    runner.run("filter/select_numeric" + suffix, universe, [&](std::size_t) {
+        numeric.select(columns, selection);
+        doNotOptimize(selection.size());
+    });
+    runner.run("filter/select_text" + suffix, universe, [&](std::size_t) {
+        text.select(columns, selection);
+        doNotOptimize(selection.size());
+    });
+}
+
+void benchSimulator(BenchRunner &runner, std::size_t max_universe) {
+    std::size_t universe = std::min<std::size_t>(100000, max_universe);
+    std::string step_name = "sim/step/" + std::to_string(universe);
+    std::string check_name = "sim/step/batch_independent";
+    if (!runner.enabled(step_name) && !runner.enabled(check_name)) return;
+
+    std::vector<TickerId> ids(universe);
+    for (std::size_t i = 0; i < universe; ++i) ids[i] = static_cast<TickerId>(i);
+    std::vector<Quote> quotes(universe);
+
+    MarketSimulator simulator(42);
+    runner.run(step_name, universe, [&](std::size_t) {
+        simulator.advance(universe);
+        simulator.step(ids, quotes);
+        doNotOptimize(quotes.data());
+    });
+
+    if (!runner.enabled(check_name)) return;
+    // A ticker's path depends only on the seed, not on how the universe is
+    // split into calls (as worker threads split it).
+    MarketSimulator whole(7);
+    MarketSimulator split(7);
+    std::vector<Quote> expected(universe);
+    bool identical = true;
+    for (std::size_t tick = 0; tick < 8; ++tick) {
+        whole.advance(universe);
+        whole.step(ids, expected);
+        split.advance(universe);
+        for (std::size_t begin = 0; begin < universe; begin += 997) {
+            std::size_t end = std::min(universe, begin + 997);
+            split.step(std::span<const TickerId>(ids).subspan(begin, end - begin),
+                       std::span<Quote>(quotes).subspan(begin, end - begin));
+        }
+        identical = identical && std::memcmp(expected.data(), quotes.data(), universe * sizeof(Quote)) == 0;
+    }
+    runner.check(check_name, identical);
+}
+
+void benchFeed(BenchRunner &runner, const std::filesystem::path &dir) {
+    constexpr std::size_t kMessages = 100000;
+    std::string decode_name = "feed/decode/" + std::to_string(kMessages);
+    std::string cache_name = "feed/decode_to_cache/" + std::to_string(kMessages);
+    std::string mmap_name = "feed/decode_mmap/" + std::to_string(kMessages);
+    std::string split_name = "feed/decode/split_buffers";
+    if (runner.enabled(decode_name) || runner.enabled(cache_name) || runner.enabled(mmap_name) ||
+        runner.enabled(split_name)) {
+        SyntheticMarket market(kMessages, 1);
+        auto quotes = market.tick(0);
+        std::string stream;
+        for (std::size_t i = 0; i < quotes.size(); ++i) {
+            quote_message::appendQuote(stream, i + 1, static_cast<TickerId>(i), quotes[i]);
+        }
+
+        // Framing alone: walk the messages and touch one field of each.
+        runner.run(decode_name, kMessages, [&](std::size_t) {
+            std::uint64_t checksum = 0;
+            quote_message::decode(stream, [&](quote_message::QuoteView update) { checksum += update.tickerId(); });
+            doNotOptimize(checksum);
+        });
+
+        // Decoding into a quote cache indexed by id, as FeedClient does.
+        std::vector<Quote> cache(kMessages);
+        auto decodeInto = [&](std::span<const char> bytes) {
+            return quote_message::decode(bytes, [&](quote_message::QuoteView update) {
+                cache[update.tickerId()] = update.quote();
+            });
+        };
+        runner.run(cache_name, kMessages, [&](std::size_t) {
+            decodeInto(stream);
+            doNotOptimize(cache.data());
+        });
+
+        if (runner.enabled(mmap_name)) {
+            auto path = dir / "quotes.bin";
+            std::ofstream(path, std::ios::binary).write(stream.data(), static_cast<std::streamsize>(stream.size()));
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            void *mapping = fd < 0 ? MAP_FAILED : ::mmap(nullptr, stream.size(), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (fd >= 0) ::close(fd);
+            if (mapping == MAP_FAILED) throw std::runtime_error("Cannot map " + path.string());
+            runner.run(mmap_name, kMessages, [&](std::size_t) {
+                decodeInto(std::span<const char>(static_cast<const char *>(mapping), stream.size()));
+                doNotOptimize(cache.data());
+            });
+            ::munmap(mapping, stream.size());
+        }
+
+        if (runner.enabled(split_name)) {
+            // Feeding the stream through a receive buffer in odd-sized reads,
+            // carrying partial messages over, must decode the same quotes.
+            decodeInto(stream);
+            std::vector<Quote> expected = cache;
+            std::fill(cache.begin(), cache.end(), Quote{});
+            std::vector<char> buffer(4096);
+            std::size_t buffered = 0;
+            std::size_t messages = 0;
+            bool clean = true;
+            for (std::size_t offset = 0, chunk = 1; offset < stream.size(); chunk = chunk * 7 % 1021 + 1) {
+                std::size_t n = std::min({chunk, stream.size() - offset, buffer.size() - buffered});
+                std::memcpy(buffer.data() + buffered, stream.data() + offset, n);
+                offset += n;
+                buffered += n;
+                auto result = decodeInto(std::span<const char>(buffer.data(), buffered));
+                clean = clean && !result.malformed;
+                messages += result.messages;
+                buffered -= result.consumed;
+                std::memmove(buffer.data(), buffer.data() + result.consumed, buffered);
+            }
+            runner.check(split_name, clean && buffered == 0 && messages == kMessages &&
+                                         std::memcmp(expected.data(), cache.data(), kMessages * sizeof(Quote)) == 0);
+        }
+    }
+
+    constexpr std::size_t kTickers = 10000;
+    std::string loopback_name = "feed/loopback_updates/" + std::to_string(kTickers);
+    if (!runner.enabled(loopback_name)) return;
+
+    // A feed server flat out on a Unix socket, and a client taking every
+    // update into its cache: end-to-end cost per update on one machine.
+    auto endpoint = FeedEndpoint::parse("unix:" + (dir / "feed.sock").string());
+    FeedServer server({endpoint, 0, 1});
+    std::atomic_bool serving{true};
+    std::thread server_thread([&] { server.run(serving); });
+
+    SymbolTable symbols;
+    std::vector<TickerId> ids;
+    for (std::size_t i = 0; i < kTickers; ++i) ids.push_back(symbols.intern("F" + std::to_string(i)));
+    {
+        FeedClient client(symbols, endpoint);
+        client.beginTick(ids);
+        runner.run(loopback_name, 100000, [&](std::size_t ops) {
+            auto target = client.stats().updates + ops;
+            while (client.stats().updates < target) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    serving.store(false);
+    server_thread.join();
+}
+
+void benchDaemon(BenchRunner &runner, const std::filesystem::path &dir) {
+    // Requests and replies survive encoding, including binary bytes in the
+    // text fields.
+    std::string check_name = "daemon/protocol_round_trip";
+    if (runner.enabled(check_name)) {
+        daemon_protocol::Request request{daemon_protocol::Command::AlertsOnly, SortKey::Spread, 25, 3, "BRK.B",
+                                         std::string("price > 20\0x", 12)};
+        daemon_protocol::Reply reply{2, std::string(70000, 'x'), "warning\n"};
+        std::string message;
+        daemon_protocol::appendRequest(message, request);
+        daemon_protocol::Request request_back;
+        bool ok = daemon_protocol::parseRequest(message, request_back) && request_back.command == request.command &&
+                  request_back.sort == request.sort && request_back.top == 25 && request_back.page == 3 &&
+                  request_back.symbol == request.symbol && request_back.where == request.where &&
+                  !daemon_protocol::parseReply(message, reply) &&
+                  !daemon_protocol::parseRequest(std::string_view(message).substr(0, message.size() - 1), request_back);
+        message.clear();
+        daemon_protocol::appendReply(message, reply);
+        daemon_protocol::Reply reply_back;
+        ok = ok && daemon_protocol::parseReply(message, reply_back) && reply_back.status == 2 &&
+             reply_back.out == reply.out && reply_back.err == reply.err;
+        runner.check(check_name, ok);
+    }
+
+    // A screener query answered by a daemon from memory: connect, request,
+    // and a reply the size of a 50-row table, over a Unix socket.
+    std::string round_trip_name = "daemon/round_trip";
+    if (!runner.enabled(round_trip_name)) return;
+    std::string path = (dir / "daemon.sock").string();
+    DaemonServer server(path);
+    std::atomic_bool serving{true};
+    std::string table(50 * 160, '-');
+    std::thread server_thread([&] {
+        while (serving.load()) {
+            server.serveUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(10),
+                              [&](const daemon_protocol::Request &, daemon_protocol::Reply &reply) { reply.out = table; });
+        }
+    });
+    daemon_protocol::Request request;
+    request.command = daemon_protocol::Command::Alerts;
+    bool answered = true;
+    runner.run(round_trip_name, 200, [&](std::size_t ops) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            auto reply = callDaemon(path, request);
+            answered = answered && reply && reply->out.size() == table.size();
+        }
+    });
+    serving.store(false);
+    server_thread.join();
+    if (!answered) throw std::runtime_error("daemon round trip failed");
+}
+
+void benchMetrics(BenchRunner &runner) {
+    StageMetrics metrics;
+    std::uint64_t ns = 1;
+    runner.run("metrics/record", 1000000, [&](std::size_t ops) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            ns = ns * 6364136223846793005ULL + 1442695040888963407ULL;
+            metrics.record(Stage::Evaluate, std::chrono::nanoseconds(ns >> 40));
+        }
+    });
+
+    // Threads recording at once each keep their own slot; a snapshot taken
+    // afterwards sees every sample exactly once, at its bucket's precision.
+    std::string check_name = "metrics/concurrent_totals";
+    if (!runner.enabled(check_name)) return;
+    constexpr std::uint64_t kPerThread = 200000;
+    StageMetrics shared;
+    std::vector<std::thread> threads;
+    for (std::uint64_t t = 1; t <= 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (std::uint64_t i = 0; i < kPerThread; ++i) {
+                shared.record(Stage::Fetch, std::chrono::nanoseconds(1000 * t));
+            }
+            shared.count(FrameCounter::Fetched, kPerThread);
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    auto snapshot = shared.snapshot();
+    const auto &fetch = snapshot->stages[static_cast<std::size_t>(Stage::Fetch)];
+    auto near = [](std::uint64_t value, std::uint64_t expected) {
+        return value >= expected && value <= expected + expected / 32;
+    };
+    runner.check(check_name, fetch.count() == 4 * kPerThread && fetch.max() == 4000 &&
+                                 near(fetch.percentile(0.5), 2000) && near(fetch.percentile(0.99), 4000) &&
+                                 snapshot->frames[static_cast<std::size_t>(FrameCounter::Fetched)] == 4 * kPerThread);
+}
+
+void benchMetricsExport(BenchRunner &runner) {
+    // What --metrics-port adds to each drawn frame, and what a scrape costs
+    // the server thread.
+    StageMetrics metrics;
+    for (std::uint64_t i = 1; i <= 10000; ++i) {
+        metrics.record(static_cast<Stage>(i % kStageCount), std::chrono::nanoseconds(i * 37));
+    }
+    DoubleBuffer<MetricsSnapshot> published;
+    runner.run("metrics/publish", 200, [&](std::size_t ops) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            published.publish(MetricsSnapshot::from(*metrics.snapshot(), 500, 1.0));
+        }
+    });
+    std::string text;
+    runner.run("metrics/prometheus_text", 2000, [&](std::size_t ops) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            text.clear();
+            appendPrometheusText(text, published.latest(), 1 << 20);
+            doNotOptimize(text.data());
+        }
+    });
+
+    // A reader racing a writer only ever sees whole snapshots.
+    std::string check_name = "metrics/double_buffer_consistent";
+    if (!runner.enabled(check_name)) return;
+    DoubleBuffer<MetricsSnapshot> shared;
+    std::atomic_bool done{false};
+    bool consistent = true;
+    std::thread reader([&] {
+        while (!done.load()) {
+            MetricsSnapshot seen = shared.latest();
+            for (std::uint64_t value : seen.frames) consistent &= value == seen.tracked_tickers;
+            for (std::uint64_t value : seen.alerts) consistent &= value == seen.tracked_tickers;
+        }
+    });
+    MetricsSnapshot snapshot;
+    for (std::uint64_t i = 1; i <= 200000; ++i) {
+        snapshot.frames.fill(i);
+        snapshot.alerts.fill(i);
+        snapshot.tracked_tickers = i;
+        shared.publish(snapshot);
+    }
+    done.store(true);
+    reader.join();
+    runner.check(check_name, consistent && shared.latest().tracked_tickers == 200000);
+}
+
+void benchStorage(BenchRunner &runner, const std::filesystem::path &dir) {
+    Storage storage((dir / "bench.db").string());
+    std::size_t next_symbol = 0;
+
+    runner.run("storage/add_ticker", 200, [&](std::size_t ops) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            storage.addTicker("ADD" + std::to_string(next_symbol++), "Bench Corp", "Tech");
+        }
+    });
+
+    runner.run("storage/import_tickers/10000", 10000, [&](std::size_t ops) {
+        std::size_t produced = 0;
+        Storage::BulkResult result;
+        storage.importTickers(
+            [&](TickerRecord &record) {
+                if (produced == ops) return false;
+                ++produced;
+                record.ticker = "IMP" + std::to_string(next_symbol++);
+                record.name = "Bench Corp";
+                record.sector = "Tech";
+                return true;
+            },
+            result);
+    });
+
+    runner.run("storage/list_tickers/cached", 10000, [&](std::size_t ops) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            doNotOptimize(storage.listTickers()->size());
+        }
+    });
+
+    // Removing an unknown symbol changes nothing but marks the snapshot stale,
+    // so each op measures a full reload of the table.
+    runner.run("storage/list_tickers/reload", 5, [&](std::size_t ops) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            storage.removeTicker("__missing__");
+            doNotOptimize(storage.listTickers()->size());
+        }
+    });
+
+    SyntheticMarket market(10000, 1);
+    auto rows = makeRows(market, 0);
+    runner.run("export/csv/10000_rows", rows.size(), [&](std::size_t) {
+        storage.exportToCsv((dir / "bench_export.csv").string(), rows);
+    });
+}
+
+void printUsage() {
+    std::cout << "Usage: quantis_bench [options]\n"
+              << "  --filter TEXT        run only benchmarks whose name contains TEXT\n"
+              << "  --json PATH|-        write machine-readable results to PATH (or stdout)\n"
+              << "  --repetitions N      timed samples per benchmark (default 15)\n"
+              << "  --max-universe N     largest anomaly universe (default 100000; 1000000 needs ~2 GB)\n";
+}
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    std::string json_path;
+    std::size_t max_universe = 100000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << "\n";
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--filter") {
+            options.filter = value();
+        } else if (arg == "--json") {
+            json_path = value();
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::max(1ul, std::stoul(value()));
+        } else if (arg == "--max-universe") {
+            max_universe = std::stoul(value());
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    auto dir = std::filesystem::temp_directory_path() / ("quantis_bench_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+
+    BenchRunner runner(options);
+    try {
+        benchStatsBuffer(runner);
+        benchAnomaly(runner, max_universe);
+        benchShardedAnomaly(runner, max_universe);
+        benchAnomalySnapshot(runner, dir, max_universe);
+        benchRenderer(runner);
+        benchFilter(runner, max_universe);
+        benchSimulator(runner, max_universe);
+        benchFeed(runner, dir);
+        benchDaemon(runner, dir);
+        benchMetrics(runner);
+        benchMetricsExport(runner);
+        benchStorage(runner, dir);
+    } catch (const std::exception &ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << "\n";
+        std::filesystem::remove_all(dir);
+        return 1;
+    }
+    std::filesystem::remove_all(dir);
+
+    runner.printTable(json_path == "-" ? std::cerr : std::cout);
+    if (json_path == "-") {
+        runner.writeJson(std::cout);
+    } else if (!json_path.empty()) {
+        std::ofstream json(json_path);
+        runner.writeJson(json);
+    }
+    return runner.allChecksPassed() ? 0 : 2;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Splits one CSV line into fields, honouring double-quoted fields and ""
+// escapes inside them. `fields` is cleared first so it can be reused.
+void splitCsvLine(std::string_view line, std::vector<std::string> &fields);
+
+// Appends RFC 4180 rows to a caller-owned buffer. Every field is quoted and
+// embedded quotes are doubled; numbers are formatted with std::to_chars
+// (doubles as "%.6g", matching the previous iostream output). The buffer is
+// only appended to, so a reused buffer stops allocating once it has grown.
+class CsvFormatter {
+public:
+    explicit CsvFormatter(std::string &out) : out_(out) {}
+
+    void field(std::string_view text);
+    void field(double value);
+    void field(long long value);
+    void endRow();
+
+private:
+    void separator();
+
+    std::string &out_;
+    bool row_started_{false};
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+// Latest-value handoff from one writer to any number of readers; neither
+// side ever blocks the other. publish() fills the buffer readers are not
+// pointed at and then flips the index. Each buffer carries a sequence number
+// that is odd while it is being written; a reader that finds its buffer
+// rewritten under it (only possible if two publishes land during one copy)
+// copies again. T is copied bytewise, so it must be trivially copyable.
+template <typename T>
+class DoubleBuffer {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    DoubleBuffer() = default;
+    DoubleBuffer(const DoubleBuffer &) = delete;
+    DoubleBuffer &operator=(const DoubleBuffer &) = delete;
+
+    // Single writer: call from one thread only.
+    void publish(const T &value) {
+        std::uint32_t next = current_.load(std::memory_order_relaxed) ^ 1u;
+        Buffer &buffer = buffers_[next];
+        std::uint64_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+        buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        buffer.value = value;
+        buffer.sequence.store(sequence + 2, std::memory_order_release);
+        current_.store(next, std::memory_order_release);
+    }
+
+    // Value-initialized T until the first publish().
+    T latest() const {
+        while (true) {
+            const Buffer &buffer = buffers_[current_.load(std::memory_order_acquire)];
+            std::uint64_t before = buffer.sequence.load(std::memory_order_acquire);
+            if (before & 1u) continue;
+            T value = buffer.value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer.sequence.load(std::memory_order_relaxed) == before) return value;
+        }
+    }
+
+private:
+    struct Buffer {
+        alignas(64) std::atomic<std::uint64_t> sequence{0};
+        T value{};
+    };
+
+    std::array<Buffer, 2> buffers_;
+    std::atomic<std::uint32_t> current_{0};
+};
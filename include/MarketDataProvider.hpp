@@ -1,17 +1,26 @@
 #pragma once
 
 #include "Types.hpp"
-#include <random>
-#include <string>
+#include <memory>
+#include <span>
 
+// Source of quotes for the screener. The engine calls beginTick() once per
+// tick on its primary provider, then getQuotes() for contiguous chunks of
+// the tick's ids, possibly from several worker threads.
 class MarketDataProvider {
 public:
-    MarketDataProvider();
-    Quote getQuote(const std::string &ticker);
-
-private:
-    std::mt19937 rng_;
-};
+    virtual ~MarketDataProvider() = default;
 
+    // Announces the ids the coming tick will quote, in table order.
+    virtual void beginTick(std::span<const TickerId> ids) { (void)ids; }
 
+    // Fills quotes[i] for ids[i].
+    virtual void getQuotes(std::span<const TickerId> ids, std::span<Quote> quotes) = 0;
 
+    // A provider for another worker thread, seeded with `seed` if it draws
+    // random numbers, or null when this one may be shared between threads.
+    virtual std::unique_ptr<MarketDataProvider> forWorker(unsigned long seed) {
+        (void)seed;
+        return nullptr;
+    }
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "SymbolTable.hpp"
+#include "Types.hpp"
+#include "quantis/archive/TickArchive.hpp"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One recorded tick: every quote that shares a timestamp.
+struct ReplayTick {
+    std::int64_t timestamp_ns{};
+    std::vector<TickerId> ids;
+    std::vector<Quote> quotes;
+};
+
+// Streams recorded ticks from either a tick archive (--record output) or a
+// CSV in the exportToCsv column layout. CSV carries no timestamps: a tick
+// ends when a ticker repeats, and ticks are spaced `csv_tick_interval_ns`
+// apart. Ticker ids are interned into the reader's own symbol table.
+class ReplayReader {
+public:
+    ReplayReader(const std::string &path, std::int64_t csv_tick_interval_ns);
+
+    // Replaces `tick` with the next recorded tick; false at end of input.
+    bool next(ReplayTick &tick);
+
+    const SymbolTable &symbols() const;
+
+private:
+    bool nextFromArchive(ReplayTick &tick);
+    bool nextFromCsv(ReplayTick &tick);
+    bool readCsvRow(TickerId &id, Quote &quote);
+
+    SymbolTable symbols_;
+
+    std::unique_ptr<TickArchiveReader> archive_;
+    std::vector<TickerId> archive_ids_;
+    std::size_t block_{0};
+    std::size_t row_{0};
+
+    std::ifstream csv_;
+    std::string line_;
+    std::vector<std::string> fields_;
+    std::vector<std::uint32_t> seen_in_tick_;
+    std::uint32_t csv_tick_{0};
+    std::int64_t csv_interval_ns_;
+    bool has_pending_{false};
+    TickerId pending_id_{};
+    Quote pending_quote_;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Types.hpp"
+#include "quantis/anomaly/Alerts.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+enum class SortKey {
+    Ticker,        // storage order
+    PercentChange, // largest absolute daily move first
+    Volume,        // highest volume first
+    Spread,        // widest ask - bid first
+    Alerts         // most alerts raised first
+};
+
+// Ranks screener rows by one column and keeps the leading ranks between
+// ticks. Each tick re-reads the sort keys, but only rows that were ranked
+// last tick or now beat last tick's cutoff are sorted, so the sorting work
+// follows the page size rather than the universe. Ties keep storage order.
+class RowRanking {
+public:
+    explicit RowRanking(SortKey key);
+
+    // Row indices holding ranks [begin, end), best first. `alerts` may be
+    // empty unless the key is Alerts. The span is valid until the next call.
+    std::span<const std::uint32_t> select(const ScreenerRows &rows, const std::vector<AlertSet> &alerts,
+                                          std::size_t begin, std::size_t end);
+
+private:
+    void loadKeys(const ScreenerRows &rows, const std::vector<AlertSet> &alerts);
+    double rankCandidates(std::size_t limit);
+    bool better(std::uint32_t a, std::uint32_t b) const;
+
+    SortKey key_;
+    std::vector<double> keys_;
+    std::vector<std::uint32_t> ranked_;     // last tick's leading rows, page first
+    std::vector<std::uint32_t> candidates_;
+    std::vector<std::uint8_t> is_ranked_;   // per row: member of ranked_
+    double cutoff_{0.0};                    // lowest key in ranked_
+};
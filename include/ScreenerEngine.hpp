@@ -1,34 +1,103 @@
 #pragma once
 
 #include "MarketDataProvider.hpp"
+#include "RowRanking.hpp"
 #include "Storage.hpp"
 #include "TableRenderer.hpp"
-#include "quantis/anomaly/AnomalyEngine.hpp"
+#include "TerminalPainter.hpp"
+#include "WorkerPool.hpp"
+#include "quantis/anomaly/ShardedAnomalyEngine.hpp"
+#include "quantis/archive/TickArchive.hpp"
+#include "quantis/daemon/DaemonProtocol.hpp"
+#include "quantis/filter/FilterExpression.hpp"
+#include "quantis/metrics/StageMetrics.hpp"
+#include "quantis/sim/MarketSimulator.hpp"
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+// Which rows a table view shows: the whole table in ticker order, or with
+// --sort/--top/--page one page of a ranking.
+struct ViewSpec {
+    SortKey sort{SortKey::Ticker};
+    std::size_t top{0};
+    std::size_t page{1};
+
+    bool paged() const { return sort != SortKey::Ticker || top > 0; }
+};
+
 class ScreenerEngine {
 public:
     ScreenerEngine(Storage &storage, MarketDataProvider &provider, TableRenderer &renderer);
-    ScreenerEngine(Storage &storage, MarketDataProvider &provider, TableRenderer &renderer, AnomalyEngine &anomaly);
+    ~ScreenerEngine();
     int run(int argc, char **argv);
 
+    // Runs `quantis screener ...` through a running `quantis daemon` when the
+    // command is one the daemon answers; std::nullopt means run it locally.
+    // Needs no Storage, so callers try it before opening the database.
+    static std::optional<int> forwardToDaemon(int argc, char **argv);
+
 private:
-    int handleScreener(const std::vector<std::string> &args);
+    bool applyOptions(std::vector<std::string> &args);
+    int handleScreener(std::vector<std::string> args);
+    int handleDaemon(std::vector<std::string> args);
+    int runDaemon();
+    void answerRequest(const daemon_protocol::Request &request, const ScreenerRows &rows,
+                       const std::vector<AlertSet> &alerts, daemon_protocol::Reply &reply);
     int handleList(bool realtime);
     int handleAlerts(bool realtime, bool alertsOnly);
-    int handleAlertsClear();
-    int handleAdd(const std::string &ticker);
-    int handleRemove(const std::string &ticker);
-    int handleExport();
+    int runRealtime(bool withAlerts, bool alertsOnly);
+    int handleAlertsClear(std::ostream &out, std::ostream &err);
+    int handleStats();
+    int handleAdd(const std::string &ticker, std::ostream &out, std::ostream &err);
+    int handleRemove(const std::string &ticker, std::ostream &out, std::ostream &err);
+    int handleImport(const std::string &path);
+    int handleBulkRemove(const std::string &path);
+    int handleReplay(const std::string &path, double speed);
+    int handleExport(const std::string &filename);
+
+    std::string_view formatView(const ViewSpec &view, RowRanking &ranking, const ScreenerRows &rows, const std::vector<AlertSet> &alerts,
+                                bool withAlerts, bool alertsOnly);
 
+    void useProvider(std::unique_ptr<MarketDataProvider> provider);
+    void configureWorkers(std::size_t threads);
+    MarketDataProvider &providerFor(std::size_t worker);
     ScreenerRows collectRows();
+    void applyFilter(ScreenerRows &rows);
+    std::vector<AlertSet> evaluateAlerts(const ScreenerRows &rows);
+    void restoreAnomalies(std::ostream &out);
+    void checkpointAnomalies(const ScreenerRows &rows);
+    void awaitCheckpoint();
 
     Storage &storage_;
-    MarketDataProvider &provider_;
+    MarketDataProvider *provider_;
+    std::unique_ptr<MarketDataProvider> owned_provider_;
     TableRenderer &renderer_;
-    AnomalyEngine *anomaly_;
-    std::unique_ptr<AnomalyEngine> owned_anomaly_;
+    std::unique_ptr<WorkerPool> pool_;
+    std::unique_ptr<ShardedAnomalyEngine> anomaly_;
+    std::vector<std::unique_ptr<MarketDataProvider>> worker_providers_;
+    std::unique_ptr<MarketSimulator> simulator_;
+    std::vector<TickerId> fetch_ids_;
+    std::vector<Quote> fetch_quotes_;
+    std::chrono::milliseconds interval_{1000};
+    RepaintMode repaint_{RepaintMode::Diff};
+    ViewSpec view_; // from this process's own options
+    std::optional<FilterExpression> filter_;
+    QuoteColumns filter_columns_;
+    std::vector<std::uint32_t> filter_selection_;
+    std::unique_ptr<TickArchiveWriter> recorder_;
+    StageMetrics metrics_;
+    std::uint16_t metrics_port_{0};
+    std::atomic<std::size_t> tracked_tickers_{0};
+    // Anomaly checkpoints are captured into checkpoint_image_ by the thread
+    // evaluating alerts and written out by checkpoint_writer_.
+    std::string checkpoint_image_;
+    std::thread checkpoint_writer_;
+    std::atomic_bool checkpoint_writing_{false};
 };
@@ -1,30 +1,81 @@
 #pragma once
 
+#include "SymbolTable.hpp"
 #include "Types.hpp"
+#include <functional>
+#include <iostream>
 #include <sqlite3.h>
 #include <string>
 #include <vector>
 
+class WorkerPool;
+
 class Storage {
 public:
+    struct BulkResult {
+        std::size_t applied{};
+        std::size_t unchanged{};
+    };
+
     explicit Storage(const std::string &db_path);
     ~Storage();
 
+    // Single-ticker writes report failures to `err`.
     bool addTicker(const std::string &ticker,
                    const std::string &name = "",
                    const std::string &sector = "",
                    const std::string &industry = "",
-                   const std::string &notes = "");
-    bool removeTicker(const std::string &ticker);
-    std::vector<TickerRecord> listTickers();
-    bool exportToCsv(const std::string &filename, const ScreenerRows &rows);
+                   const std::string &notes = "",
+                   std::ostream &err = std::cerr);
+    bool removeTicker(const std::string &ticker, std::ostream &err = std::cerr);
+
+    // Bulk variants pull entries from `next` until it returns false and apply
+    // them in a single transaction; any failure rolls the whole batch back.
+    bool importTickers(const std::function<bool(TickerRecord &)> &next, BulkResult &result);
+    bool removeTickers(const std::function<bool(std::string &)> &next, BulkResult &result);
+
+    // Returns the cached ticker snapshot, reloading it only when this
+    // connection or another process has changed the database since the
+    // last call. A reload makes a new snapshot; earlier ones stay valid for
+    // as long as they are held.
+    TickerSnapshot listTickers();
+    // Writes rows as RFC 4180 CSV to `filename` ("-" for stdout). Large
+    // exports are formatted in parallel chunks when a pool is given.
+    bool exportToCsv(const std::string &filename, const ScreenerRows &rows, WorkerPool *pool = nullptr);
+    // Appends the same CSV to `out`.
+    void exportToCsv(std::string &out, const ScreenerRows &rows, WorkerPool *pool = nullptr);
+
+    SymbolTable &symbols();
 
 private:
+    enum class WriteResult {
+        Applied,
+        Unchanged,
+        Failed
+    };
+
     void initialize();
-    bool tickerExists(const std::string &ticker);
+    void prepareStatements();
+    sqlite3_stmt *prepare(const char *sql);
+    bool execute(const char *sql);
+    bool commit();
+    WriteResult insertTicker(const TickerRecord &record, std::ostream &err);
+    WriteResult deleteTicker(const std::string &ticker, std::ostream &err);
+    long long dataVersion();
+    void reloadSnapshot();
 
     sqlite3 *db_{};
     std::string db_path_;
+    SymbolTable symbols_;
+
+    sqlite3_stmt *insert_stmt_{};
+    sqlite3_stmt *delete_stmt_{};
+    sqlite3_stmt *select_stmt_{};
+    sqlite3_stmt *version_stmt_{};
+
+    TickerSnapshot snapshot_;
+    long long snapshot_version_{-1};
+    bool snapshot_stale_{true};
 };
 
 
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Assigns each ticker symbol a dense, stable TickerId the first time it is
+// seen so hot paths can index contiguous arrays instead of hashing strings.
+class SymbolTable {
+public:
+    static constexpr TickerId kInvalidId = static_cast<TickerId>(-1);
+
+    TickerId intern(std::string_view symbol);
+    TickerId find(std::string_view symbol) const;
+    const std::string &symbol(TickerId id) const;
+    std::size_t size() const;
+
+    // Name the market data feed published for `id`, or `fallback` if none.
+    // Names are write-once and never move, so the view stays valid for the
+    // table's lifetime. Name calls are safe from any thread.
+    std::string_view displayName(TickerId id, std::string_view fallback) const;
+    void setName(TickerId id, std::string_view name);
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view value) const { return std::hash<std::string_view>{}(value); }
+    };
+
+    std::unordered_map<std::string, TickerId, Hash, std::equal_to<>> ids_;
+    std::vector<std::string> symbols_;
+
+    mutable std::shared_mutex names_mutex_;
+    std::deque<std::string> names_;
+    std::vector<std::uint32_t> name_slots_; // per id: index into names_ plus one, 0 when unnamed
+};
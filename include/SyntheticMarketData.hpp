@@ -0,0 +1,40 @@
+#pragma once
+
+#include "MarketDataProvider.hpp"
+#include "SymbolTable.hpp"
+#include "Types.hpp"
+#include "quantis/sim/MarketSimulator.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+// Local stand-in for a market data feed: independent random draws per
+// quote, or a MarketSimulator's paths once one is attached.
+class SyntheticMarketData : public MarketDataProvider {
+public:
+    explicit SyntheticMarketData(SymbolTable &symbols);
+    SyntheticMarketData(SymbolTable &symbols, unsigned long seed);
+    Quote getQuote(const std::string &ticker);
+
+    // Advances the attached simulator, if any.
+    void beginTick(std::span<const TickerId> ids) override;
+
+    // A ticker's display name is published to the symbol table the first
+    // time this provider quotes it.
+    void getQuotes(std::span<const TickerId> ids, std::span<Quote> quotes) override;
+
+    // Shares this provider's simulator, if any.
+    std::unique_ptr<MarketDataProvider> forWorker(unsigned long seed) override;
+
+    // Serves quotes from `simulator` (not owned) instead of independent random
+    // draws; null switches back.
+    void setSimulator(MarketSimulator *simulator);
+
+private:
+    Quote nextQuote();
+
+    SymbolTable &symbols_;
+    std::mt19937 rng_;
+    MarketSimulator *simulator_{nullptr};
+    std::vector<bool> named_;
+};
@@ -1,18 +1,53 @@
 #pragma once
 
+#include "SymbolTable.hpp"
 #include "Types.hpp"
-#include <vector>
+#include "quantis/anomaly/Alerts.hpp"
+#include <cstdint>
+#include <iostream>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
+
+// A window of ranked rows to show instead of the whole table.
+struct RowSelection {
+    std::span<const std::uint32_t> rows; // indices into the table, in display order
+    std::size_t first_rank{};            // 0-based rank of rows[0]
+};
 
+// Formats screener tables into a reusable frame buffer. Once the buffer has
+// grown to the frame size, rendering does not touch the heap.
 class TableRenderer {
 public:
+    explicit TableRenderer(std::ostream &out = std::cout);
+    // Shows the feed's display names from `names` in place of stored names.
+    explicit TableRenderer(const SymbolTable &names, std::ostream &out = std::cout);
+
+    // Format a frame and write it to the output stream.
     void render(const ScreenerRows &rows);
-    void renderWithAlerts(const ScreenerRows &rows, const std::vector<std::vector<std::string>> &alerts,
-                          bool alertsOnly);
+    void renderWithAlerts(const ScreenerRows &rows, const std::vector<AlertSet> &alerts, bool alertsOnly);
+
+    // Format a frame without writing it. The view stays valid until the next
+    // call on this renderer.
+    std::string_view format(const ScreenerRows &rows);
+    std::string_view formatWithAlerts(const ScreenerRows &rows, const std::vector<AlertSet> &alerts, bool alertsOnly);
+
+    // Format only the selected rows, followed by a "Rows A-B of N" line.
+    std::string_view format(const ScreenerRows &rows, const RowSelection &selection);
+    std::string_view formatWithAlerts(const ScreenerRows &rows, const std::vector<AlertSet> &alerts, bool alertsOnly,
+                                      const RowSelection &selection);
 
 private:
-    static std::string formatNumber(double value, int precision = 2);
-    static std::string formatLargeNumber(double value);
-    static std::string colorize(const std::string &alert);
-    static std::string joinAlerts(const std::vector<std::string> &alerts);
+    void appendRow(const TickerRecord &meta, const Quote &q);
+    void appendAlertsRow(const TickerRecord &meta, const Quote &q, AlertSet alerts, bool alertsOnly);
+    void appendAlertsHeader(bool alertsOnly);
+    void appendQuoteColumns(const TickerRecord &meta, const Quote &q);
+    void appendFooter(const RowSelection &selection, std::size_t total);
+    std::string_view joinAlerts(AlertSet alerts);
+
+    const SymbolTable *names_{nullptr};
+    std::ostream *out_;
+    std::string frame_;
+    std::string alerts_text_;
 };
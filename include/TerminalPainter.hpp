@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class RepaintMode {
+    Full, // clear the screen and print the whole frame
+    Diff  // rewrite only the cells that changed since the last frame
+};
+
+// Puts rendered frames on the terminal, each with a single write().
+//
+// In Diff mode the painter keeps the previous frame as a grid of cells
+// (glyph plus SGR colour) sized to the terminal and emits cursor moves and
+// text only for cells whose content changed. Frames are clipped to the
+// window. The first frame, and any frame after the window was resized, is a
+// full redraw. When the output is not a terminal, Diff behaves like Full.
+class TerminalPainter {
+public:
+    TerminalPainter(RepaintMode mode, int fd);
+    ~TerminalPainter();
+
+    TerminalPainter(const TerminalPainter &) = delete;
+    TerminalPainter &operator=(const TerminalPainter &) = delete;
+
+    // Paints newline-separated text, which may carry SGR colour sequences.
+    bool paint(std::string_view frame);
+
+    // Bytes handed to the terminal by the last paint().
+    std::size_t lastFrameBytes() const;
+
+private:
+    struct Cell {
+        char glyph[4]{' '};
+        std::uint8_t size{1};
+        std::uint8_t style{0};
+
+        bool operator==(const Cell &other) const;
+    };
+
+    bool updateSize();
+    void layout(std::string_view frame);
+    std::uint8_t internStyle(std::string_view sequence);
+    void emitChanges();
+    void moveTo(std::size_t row, std::size_t col);
+    void setStyle(std::uint8_t style);
+    bool flush();
+
+    RepaintMode mode_;
+    int fd_;
+    std::size_t rows_{0};
+    std::size_t cols_{0};
+    std::vector<Cell> current_;
+    std::vector<Cell> next_;
+    std::vector<std::string> styles_; // index 0 is the default style
+    std::string out_;
+    std::size_t cursor_row_{0};
+    std::size_t cursor_col_{0};
+    std::uint8_t active_style_{0};
+    bool cursor_hidden_{false};
+};
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+using TickerId = std::uint32_t;
+
 struct TickerRecord {
+    TickerId id{};
     std::string ticker;
     std::string name;
     std::string sector;
@@ -12,8 +18,9 @@ struct TickerRecord {
     std::string date_added;
 };
 
+// Plain numeric payload so quotes can be memcpy'd into ring buffers,
+// archives and shared memory. Display names live in the SymbolTable.
 struct Quote {
-    std::string name;
     double price{};
     double market_cap{};
     double daily_percent_change{};
@@ -23,11 +30,19 @@ struct Quote {
     double fiftytwo_week_low{};
     double bid{};
     double ask{};
+    std::int64_t timestamp_ns{}; // when the source produced it, ns since the Unix epoch; 0 if unknown
 };
 
-using ScreenerRow = std::pair<TickerRecord, Quote>;
-using ScreenerRows = std::vector<ScreenerRow>;
-
-
+static_assert(std::is_trivially_copyable_v<Quote>);
 
+// One generation of the tracked tickers. Storage replaces it as a whole when
+// the watchlist changes, so records in it never move while it is held.
+using TickerSnapshot = std::shared_ptr<const std::vector<TickerRecord>>;
 
+// Rows point at their ticker's record rather than copying its strings every
+// tick; `tickers` keeps the snapshot they point into alive.
+using ScreenerRow = std::pair<const TickerRecord *, Quote>;
+struct ScreenerRows : std::vector<ScreenerRow> {
+    using std::vector<ScreenerRow>::vector;
+    TickerSnapshot tickers;
+};
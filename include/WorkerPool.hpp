@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that split an index range into contiguous
+// chunks, one per worker. The calling thread runs chunk 0, so a pool of size
+// 1 owns no threads and runs everything inline.
+class WorkerPool {
+public:
+    using ChunkFn = std::function<void(std::size_t worker, std::size_t begin, std::size_t end)>;
+
+    explicit WorkerPool(std::size_t workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    std::size_t size() const;
+
+    // Runs fn over [0, count) and blocks until every chunk has finished.
+    // Concurrent callers are serialized. If chunks throw, the first exception
+    // is rethrown on the caller once every chunk is done.
+    void parallelFor(std::size_t count, const ChunkFn &fn);
+
+private:
+    void workerLoop(std::size_t worker);
+    void runChunk(std::size_t worker);
+
+    std::vector<std::thread> threads_;
+    std::size_t workers_;
+
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const ChunkFn *job_{nullptr};
+    std::size_t job_count_{0};
+    std::size_t generation_{0};
+    std::size_t pending_{0};
+    std::exception_ptr error_;
+    bool stopping_{false};
+};
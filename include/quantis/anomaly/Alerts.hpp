@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// Alert codes in the order the rules are evaluated; the bit position of each
+// code in an AlertSet is its enumerator value.
+enum class AlertCode : std::uint32_t {
+    VolSpike,
+    VolatilitySurge,
+    SpreadWide,
+    BreakoutUp,
+    BreakoutDown,
+    LowLiquidity,
+    MomentumFlip,
+    Count
+};
+
+using AlertSet = std::uint32_t;
+
+inline constexpr std::size_t kAlertCount = static_cast<std::size_t>(AlertCode::Count);
+
+struct AlertInfo {
+    std::string_view name;
+    std::string_view color;
+};
+
+inline constexpr std::array<AlertInfo, kAlertCount> kAlertTable{{
+    {"VOL_SPIKE", "\033[33m"},        // yellow
+    {"VOLATILITY_SURGE", "\033[33m"}, // yellow
+    {"SPREAD_WIDE", "\033[31m"},      // red
+    {"BREAKOUT_UP", "\033[32m"},      // green
+    {"BREAKOUT_DOWN", "\033[31m"},    // red
+    {"LOW_LIQUIDITY", "\033[31m"},    // red
+    {"MOMENTUM_FLIP", "\033[34m"},    // blue
+}};
+
+constexpr AlertSet alertBit(AlertCode code) { return AlertSet{1} << static_cast<std::uint32_t>(code); }
+
+constexpr bool hasAlert(AlertSet alerts, AlertCode code) { return (alerts & alertBit(code)) != 0; }
+
+constexpr const AlertInfo &alertInfo(AlertCode code) { return kAlertTable[static_cast<std::size_t>(code)]; }
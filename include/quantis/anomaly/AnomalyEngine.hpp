@@ -1,18 +1,42 @@
 #pragma once
 
+#include "SymbolTable.hpp"
 #include "Types.hpp"
+#include "quantis/anomaly/Alerts.hpp"
+#include "quantis/anomaly/RuleKernels.hpp"
 #include "quantis/anomaly/StatsBuffer.hpp"
+#include <memory>
+#include <span>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 class AnomalyEngine {
 public:
-    std::vector<std::string> evaluate(const std::string &ticker, const Quote &quote);
+    AnomalyEngine();
+    explicit AnomalyEngine(SymbolTable &symbols);
+
+    AlertSet evaluate(TickerId id, const Quote &quote);
+    AlertSet evaluate(const std::string &ticker, const Quote &quote);
+
+    // Evaluates quotes[i] for ids[i] into out[i]. Windows are updated in
+    // order, then the rules run as SIMD passes over per-rule columns; the
+    // result is bit-identical to calling evaluate() for each entry.
+    void evaluateBatch(std::span<const TickerId> ids, std::span<const Quote> quotes, std::span<AlertSet> out,
+                       RuleKernel kernel = RuleKernel::Auto);
+    // Creates empty windows for ids below `tickers` up front, so the first
+    // tick does not pay for them.
+    void ensureTickers(std::size_t tickers);
     void clear();
 
-private:
-    std::unordered_map<std::string, StatsBuffer> buffers_;
-};
+    // Per-ticker windows by id, for checkpointing. Ids past the end have no
+    // history yet.
+    std::span<const StatsBuffer> windows() const { return buffers_; }
+    StatsBuffer &window(TickerId id) { return bufferFor(id); }
 
+private:
+    StatsBuffer &bufferFor(TickerId id);
 
+    SymbolTable *symbols_;
+    std::unique_ptr<SymbolTable> owned_symbols_;
+    std::vector<StatsBuffer> buffers_;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "SymbolTable.hpp"
+#include "Types.hpp"
+#include "quantis/anomaly/ShardedAnomalyEngine.hpp"
+#include "quantis/anomaly/StatsBuffer.hpp"
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Checkpoint of the anomaly engine's per-ticker windows, so a restarted
+// process raises history-based alerts from its first tick instead of after
+// a full window.
+//
+// Layout (little-endian, IEEE doubles, every field naturally aligned):
+//   FileHeader
+//   `tickers` records of `record_size` bytes each: a RecordHeader, then
+//   `window` Samples, oldest first, zero past `count`
+//   the symbols the records point into, unterminated
+// Tickers are stored by symbol, since TickerIds are only stable within one
+// process. Records have a fixed size, so a restore maps the file and reads
+// each record in place.
+namespace anomaly_snapshot {
+
+static_assert(std::endian::native == std::endian::little, "snapshots are read in place");
+
+inline constexpr char kMagic[8] = {'Q', 'A', 'N', 'O', 'M', 'A', 'L', 'Y'};
+inline constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t window; // StatsBuffer capacity
+    std::uint64_t tickers;
+    std::uint64_t record_size;
+    std::uint64_t names_offset;
+    std::uint64_t names_size;
+    std::int64_t saved_at; // Unix ns
+};
+
+struct RecordHeader {
+    std::uint64_t name_offset; // from names_offset
+    std::uint32_t name_length;
+    std::uint32_t count; // samples in the window
+    StatsBuffer::Aggregates aggregates;
+};
+
+static_assert(sizeof(FileHeader) == 56 && sizeof(RecordHeader) == 48 && sizeof(StatsBuffer::Sample) == 16,
+              "the snapshot layout is read in place");
+
+inline constexpr std::size_t kRecordSize =
+    sizeof(RecordHeader) + StatsBuffer::kDefaultCapacity * sizeof(StatsBuffer::Sample);
+
+struct RestoreResult {
+    std::size_t tickers{0};
+    std::int64_t saved_at{0}; // Unix ns
+    bool expired{false};      // too old; nothing was restored
+};
+
+// Serializes every window `engine` holds for a ticker `symbolOf` can name
+// (an empty name skips it) into `image`, replacing its contents but keeping
+// its capacity. Call between evaluate() calls, from the thread making them.
+void capture(const ShardedAnomalyEngine &engine, const std::function<std::string_view(TickerId)> &symbolOf,
+             std::string &image);
+
+// Writes an image from capture() to a temporary file, syncs it and renames
+// it over `path`, so `path` always holds a whole snapshot. Touches no
+// engine, so it may run on any thread. Returns false with errno set on
+// failure.
+bool write(const std::string &path, std::string_view image);
+
+// capture() and write() in one go.
+bool save(const std::string &path, const ShardedAnomalyEngine &engine,
+          const std::function<std::string_view(TickerId)> &symbolOf);
+
+// Restores the windows of tickers `idOf` knows (it returns
+// SymbolTable::kInvalidId for the rest), unless the snapshot is older than
+// `max_age`. Returns std::nullopt when `path` is missing, truncated or
+// written with another layout or window size.
+std::optional<RestoreResult> restore(const std::string &path, ShardedAnomalyEngine &engine,
+                                     const std::function<TickerId(std::string_view)> &idOf,
+                                     std::chrono::seconds max_age);
+
+} // namespace anomaly_snapshot
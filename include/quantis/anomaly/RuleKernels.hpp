@@ -0,0 +1,39 @@
+#pragma once
+
+#include "quantis/anomaly/Alerts.hpp"
+#include <cstddef>
+#include <vector>
+
+// Structure-of-arrays inputs for the anomaly rules, one entry per quote in a
+// batch. Columns that depend on integer semantics (thin_volume) or on the
+// rolling window are resolved while gathering so the rule kernels are pure
+// floating-point comparisons.
+struct RuleColumns {
+    std::vector<double> volume_ratio;  // volume / average_volume, 0 when average_volume <= 0
+    std::vector<double> thin_volume;   // 1 when volume < 40% of average_volume
+    std::vector<double> price;
+    std::vector<double> fiftytwo_week_high;
+    std::vector<double> fiftytwo_week_low;
+    std::vector<double> spread;
+    std::vector<double> mean_spread;
+    std::vector<double> price_return;
+    std::vector<double> volatility;
+    std::vector<double> short_slope;
+    std::vector<double> long_slope;
+    std::vector<double> history;       // samples in the rolling window
+
+    void resize(std::size_t count);
+};
+
+enum class RuleKernel {
+    Auto,
+    Scalar,
+    Avx2
+};
+
+// Evaluates all rules for the first `count` entries of `columns` and writes
+// one AlertSet per entry. Auto picks AVX2 when the CPU supports it; every
+// kernel produces bit-identical output.
+void evaluateRules(const RuleColumns &columns, std::size_t count, AlertSet *out, RuleKernel kernel = RuleKernel::Auto);
+
+bool ruleKernelAvailable(RuleKernel kernel);
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "SpscQueue.hpp"
+#include "Types.hpp"
+#include "quantis/anomaly/AnomalyEngine.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+// AnomalyEngine split across threads by ticker id.
+//
+// Ids are dealt to shards in blocks of 64 consecutive ids, round-robin. Each
+// shard owns an AnomalyEngine holding only its own tickers' StatsBuffers, so
+// the same core keeps a ticker's history from tick to tick and evaluation
+// takes no locks. evaluate() hands the tick to every shard through that
+// shard's SpscQueue; each shard gathers its entries, evaluates them as one
+// batch and writes the alerts back at the entries' positions, so the merged
+// result is in input order. Shard 0 runs on the calling thread, so a single
+// shard owns no threads.
+class ShardedAnomalyEngine {
+public:
+    explicit ShardedAnomalyEngine(std::size_t shards);
+    ~ShardedAnomalyEngine();
+
+    ShardedAnomalyEngine(const ShardedAnomalyEngine &) = delete;
+    ShardedAnomalyEngine &operator=(const ShardedAnomalyEngine &) = delete;
+
+    std::size_t shards() const { return shards_.size(); }
+
+    // Evaluates quotes[i] for ids[i] into out[i] and returns once every
+    // shard is done. Results are identical to AnomalyEngine::evaluateBatch
+    // over the same sequence of calls. One caller at a time.
+    void evaluate(std::span<const TickerId> ids, std::span<const Quote> quotes, std::span<AlertSet> out);
+
+    // Drops every shard's history. Safe to call from any thread: all shards
+    // clear together, before the next evaluate() looks at its tick.
+    void clear();
+
+    // Checkpointing (see AnomalySnapshot.hpp), by global ticker id. Both
+    // touch the shards' state directly: call them only between evaluate()
+    // calls, from the thread that makes them. While a clear() is pending,
+    // forEachWindow() visits nothing.
+    void forEachWindow(const std::function<void(TickerId, const StatsBuffer &)> &visit) const;
+    StatsBuffer &window(TickerId id);
+
+private:
+    struct Task {
+        bool stop{false};
+        bool clear{false};
+        bool relayout{false}; // ids differ from the previous tick
+    };
+
+    struct Shard {
+        Shard();
+
+        AnomalyEngine engine;
+        SpscQueue<Task> queue;
+        std::atomic<std::uint32_t> signal{0};
+        std::vector<std::uint32_t> positions; // this shard's entries in the tick
+        std::vector<TickerId> local_ids;
+        std::vector<Quote> quotes;
+        std::vector<AlertSet> alerts;
+        std::thread thread;
+    };
+
+    void shardLoop(std::size_t index);
+    void process(std::size_t index, const Task &task);
+    void push(Shard &shard, Task task);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    // The tick being evaluated, published to the shards by their queues.
+    std::span<const TickerId> tick_ids_;
+    std::span<const Quote> tick_quotes_;
+    std::span<AlertSet> tick_out_;
+    std::vector<TickerId> layout_ids_;
+    alignas(64) std::atomic<std::uint32_t> pending_{0};
+
+    std::atomic<std::uint64_t> clear_requests_{0};
+    std::uint64_t clears_applied_{0};
+};
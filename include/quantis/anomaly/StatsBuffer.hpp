@@ -1,12 +1,34 @@
 #pragma once
 
 #include "Types.hpp"
-#include <deque>
+#include <cstdint>
+#include <span>
 #include <vector>
 
+// Rolling per-ticker window of prices and spreads.
+//
+// Aggregates (return mean/variance via Welford, spread sum) are updated on
+// every push and eviction so all queries are O(1) and allocation-free. The
+// running values are re-derived from the window every `capacity` evictions,
+// which keeps them within ~1e-12 relative of a full two-pass rescan.
 class StatsBuffer {
 public:
-    explicit StatsBuffer(std::size_t capacity = 60);
+    struct Sample {
+        double price;
+        double spread;
+    };
+
+    // Running values kept alongside the window.
+    struct Aggregates {
+        double return_mean;
+        double return_m2;
+        double spread_sum;
+        std::uint64_t evictions;
+    };
+
+    static constexpr std::size_t kDefaultCapacity = 60;
+
+    explicit StatsBuffer(std::size_t capacity = kDefaultCapacity);
 
     void addSample(const Quote &quote);
     std::size_t size() const;
@@ -22,11 +44,33 @@ public:
     double shortTermSlope() const;
     double longTermSlope() const;
 
+    // Checkpointing. A buffer restored from what copyWindow() and
+    // aggregates() returned carries on as the saved one would have; its
+    // running values are re-derived from the window, so they match the
+    // saved ones to within the drift resync() bounds.
+    std::size_t capacity() const { return capacity_; }
+    Aggregates aggregates() const;
+    // Writes the window to `out`, oldest first; `out` needs size() entries.
+    void copyWindow(std::span<Sample> out) const;
+    // Replaces the window; extra samples beyond capacity() are ignored.
+    void restore(std::span<const Sample> window, const Aggregates &aggregates);
+
 private:
-    std::vector<double> computeReturns() const;
+    const Sample &at(std::size_t index) const;
+    double slopeOver(std::size_t window) const;
+    static double returnBetween(const Sample &prev, const Sample &next);
 
-    std::deque<Quote> samples_;
-    std::size_t capacity_;
-};
+    void pushReturn(double value);
+    void popReturn(double value);
+    void resync();
 
+    std::vector<Sample> ring_;
+    std::size_t head_{0};
+    std::size_t count_{0};
+    std::size_t capacity_;
 
+    double return_mean_{0.0};
+    double return_m2_{0.0};
+    double spread_sum_{0.0};
+    std::size_t evictions_{0};
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Types.hpp"
+#include <bit>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Binary columnar tick archive.
+//
+// Layout (little-endian, every section 8-byte aligned):
+//   FileHeader
+//   { BlockHeader, payload }*
+// A Symbols block maps ticker ids to symbol text. A Ticks block stores
+// `rows` entries as consecutive fixed-width columns in TickBlockView field
+// order, each padded to a multiple of 8 bytes. Timestamps are non-decreasing
+// across the whole file: the writer clamps any that would go back in time
+// (say, after the wall clock is stepped back) to the previous one.
+//
+// Ticker ids are the archive's own, not the recording process's: the first
+// symbol recorded gets 0, the next new one 1, and so on. That keeps them
+// meaningful across every session appended to the file.
+namespace tick_archive {
+
+static_assert(std::endian::native == std::endian::little, "archives are read in place");
+
+inline constexpr char kMagic[8] = {'Q', 'T', 'K', 'A', 'R', 'C', 'H', '1'};
+inline constexpr std::uint32_t kVersion = 2;
+
+enum class BlockKind : std::uint32_t {
+    Symbols = 1,
+    Ticks = 2
+};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+struct BlockHeader {
+    BlockKind kind;
+    std::uint32_t reserved;
+    std::uint64_t payload_bytes;
+    std::uint64_t rows;
+    std::int64_t first_timestamp;
+    std::int64_t last_timestamp;
+};
+
+static_assert(sizeof(FileHeader) % 8 == 0 && sizeof(BlockHeader) % 8 == 0);
+
+} // namespace tick_archive
+
+// Zero-copy view of (part of) one Ticks block. Spans point into the mapping
+// owned by the TickArchiveReader and stay valid for its lifetime.
+struct TickBlockView {
+    std::span<const std::int64_t> timestamp; // ns since the Unix epoch
+    std::span<const TickerId> ticker;
+    std::span<const double> price;
+    std::span<const double> market_cap;
+    std::span<const double> daily_percent_change;
+    std::span<const std::int64_t> volume;
+    std::span<const std::int64_t> average_volume;
+    std::span<const double> fiftytwo_week_high;
+    std::span<const double> fiftytwo_week_low;
+    std::span<const double> bid;
+    std::span<const double> ask;
+
+    std::size_t size() const { return timestamp.size(); }
+    TickBlockView slice(std::size_t begin, std::size_t end) const;
+    Quote quote(std::size_t row) const;
+};
+
+// Appends quotes to an archive. Rows are buffered into column blocks on the
+// caller's thread; full blocks are serialized and written by a background
+// thread so recording never waits on the disk.
+class TickArchiveWriter {
+public:
+    // Creates `path`, or appends to the archive already there after dropping
+    // any partial block a crash left at its end. Throws std::runtime_error if
+    // `path` holds something other than an archive of this version.
+    explicit TickArchiveWriter(const std::string &path, std::size_t block_rows = 65536);
+    ~TickArchiveWriter();
+
+    TickArchiveWriter(const TickArchiveWriter &) = delete;
+    TickArchiveWriter &operator=(const TickArchiveWriter &) = delete;
+
+    void append(std::int64_t timestamp_ns, TickerId id, std::string_view symbol, const Quote &quote);
+
+    // Hands the partially filled block to the writer thread.
+    void flush();
+
+private:
+    struct Block {
+        std::vector<std::pair<TickerId, std::string>> symbols;
+        std::vector<std::int64_t> timestamp;
+        std::vector<TickerId> ticker;
+        std::vector<double> price;
+        std::vector<double> market_cap;
+        std::vector<double> daily_percent_change;
+        std::vector<std::int64_t> volume;
+        std::vector<std::int64_t> average_volume;
+        std::vector<double> fiftytwo_week_high;
+        std::vector<double> fiftytwo_week_low;
+        std::vector<double> bid;
+        std::vector<double> ask;
+
+        void reserve(std::size_t rows);
+        bool empty() const { return symbols.empty() && timestamp.empty(); }
+    };
+
+    void writerLoop();
+    void writeBlock(const Block &block);
+    void writeAll(const void *data, std::size_t size);
+
+    int fd_{-1};
+    std::string path_;
+    std::size_t block_rows_;
+    Block current_;
+    std::vector<TickerId> archive_ids_; // by the caller's id
+    std::int64_t last_timestamp_{std::numeric_limits<std::int64_t>::min()};
+    std::unordered_map<std::string, TickerId> symbol_ids_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Block> sealed_;
+    bool stopping_{false};
+    std::thread writer_;
+    std::vector<char> scratch_;
+    bool failed_{false}; // writer thread only
+};
+
+// Memory-maps an archive and exposes its blocks as column spans.
+class TickArchiveReader {
+public:
+    explicit TickArchiveReader(const std::string &path);
+    ~TickArchiveReader();
+
+    TickArchiveReader(const TickArchiveReader &) = delete;
+    TickArchiveReader &operator=(const TickArchiveReader &) = delete;
+
+    const std::vector<TickBlockView> &blocks() const;
+    std::size_t rows() const;
+
+    // Ticker ids run from 0 to symbolCount() - 1. Rows of a damaged file may
+    // carry ids past that; callers skip them.
+    std::size_t symbolCount() const;
+    // Symbol recorded for `id`, or an empty view when unknown.
+    std::string_view symbol(TickerId id) const;
+
+    // Length of the file up to the end of its last valid block.
+    std::size_t validBytes() const;
+
+    // Rows with from_ns <= timestamp < to_ns, one view per overlapping block.
+    std::vector<TickBlockView> range(std::int64_t from_ns, std::int64_t to_ns) const;
+
+private:
+    void index();
+
+    const char *data_{nullptr};
+    std::size_t size_{0};
+    std::vector<TickBlockView> blocks_;
+    std::vector<std::string_view> symbols_;
+    std::size_t rows_{0};
+    std::size_t valid_bytes_{0};
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "quantis/daemon/DaemonProtocol.hpp"
+#include <optional>
+#include <string>
+
+// Sends one request to the daemon listening on `path` and waits for its
+// reply. Returns std::nullopt if no daemon accepts the connection, so the
+// caller can do the work itself; once connected, a failed exchange comes
+// back as a reply with a non-zero status and the reason in `err`.
+std::optional<daemon_protocol::Reply> callDaemon(const std::string &path, const daemon_protocol::Request &request);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "RowRanking.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Request/reply messages between screener commands and `quantis daemon`,
+// over a Unix domain socket: one request per connection, answered with one
+// reply, after which the daemon closes the connection.
+//
+// Layout (little-endian; every message starts with MessageHeader):
+//   0   MessageHeader  magic, version, type, length of the whole message
+//   Request:
+//   8   u8   Command
+//   9   u8   SortKey
+//   10  u16  reserved, zero
+//   12  u32  top (0 = all rows)
+//   16  u32  page (from 1)
+//   20  u32  symbol length, then u32 where length
+//   28  the symbol, then the --where expression, unterminated
+//   Reply:
+//   8   i32  exit status for the command
+//   12  u32  stdout length, then u32 stderr length
+//   20  stdout bytes, then stderr bytes
+namespace daemon_protocol {
+
+inline constexpr std::uint16_t kMagic = 0x4451; // "QD"
+inline constexpr std::uint8_t kVersion = 1;
+// Requests carry a symbol and a filter expression; anything bigger is not
+// one of ours.
+inline constexpr std::size_t kMaxRequestSize = 64 * 1024;
+inline constexpr std::size_t kMaxReplySize = std::size_t{1} << 31;
+
+enum class MessageType : std::uint8_t {
+    Request = 1,
+    Reply = 2
+};
+
+struct MessageHeader {
+    std::uint16_t magic;
+    std::uint8_t version;
+    MessageType type;
+    std::uint32_t length;
+};
+
+static_assert(sizeof(MessageHeader) == 8);
+
+enum class Command : std::uint8_t {
+    List = 1,    // screener list
+    Alerts,      // screener alerts
+    AlertsOnly,  // screener alerts list
+    ClearAlerts, // screener alerts clear
+    Add,         // screener add SYMBOL
+    Remove,      // screener remove SYMBOL
+    Export       // screener export csv; the CSV comes back as stdout
+};
+
+struct Request {
+    Command command{Command::List};
+    SortKey sort{SortKey::Ticker};
+    std::uint32_t top{0};
+    std::uint32_t page{1};
+    std::string symbol;
+    std::string where; // empty: no filter
+};
+
+struct Reply {
+    std::int32_t status{0};
+    std::string out;
+    std::string err;
+};
+
+void appendRequest(std::string &out, const Request &request);
+void appendReply(std::string &out, const Reply &reply);
+
+// Parse one whole message as read by readMessage(); false if it is not a
+// well-formed message of that type.
+bool parseRequest(std::span<const char> message, Request &request);
+bool parseReply(std::span<const char> message, Reply &reply);
+
+// Blocking helpers for a connected socket. readMessage() replaces `message`
+// with the next whole message, rejecting foreign data and messages longer
+// than `max_size`; both return false on a socket error or timeout.
+bool readMessage(int fd, std::string &message, std::size_t max_size);
+bool writeMessage(int fd, const std::string &message);
+
+} // namespace daemon_protocol
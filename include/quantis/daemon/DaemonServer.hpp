@@ -0,0 +1,39 @@
+#pragma once
+
+#include "quantis/daemon/DaemonProtocol.hpp"
+#include <chrono>
+#include <functional>
+#include <string>
+
+// The socket side of `quantis daemon`: listens on a Unix domain socket and
+// answers requests (see DaemonProtocol.hpp) between the daemon's ticks.
+//
+// Everything runs on the caller's thread, one connection at a time, so the
+// handler may use the daemon's state without locking. Clients send their
+// whole request as soon as they connect; one that stalls is dropped after a
+// short timeout rather than holding up the tick loop.
+class DaemonServer {
+public:
+    using Handler = std::function<void(const daemon_protocol::Request &, daemon_protocol::Reply &)>;
+
+    // Binds `path`, replacing a stale socket file but refusing to take over
+    // one a live daemon still answers on. Throws std::runtime_error.
+    explicit DaemonServer(std::string path);
+    ~DaemonServer();
+
+    DaemonServer(const DaemonServer &) = delete;
+    DaemonServer &operator=(const DaemonServer &) = delete;
+
+    // Answers requests until `deadline` or a signal interrupts the wait, and
+    // returns how many were answered.
+    std::size_t serveUntil(std::chrono::steady_clock::time_point deadline, const Handler &handler);
+
+private:
+    void answer(int fd, const Handler &handler);
+
+    std::string path_;
+    int listen_fd_{-1};
+    std::string message_;
+    daemon_protocol::Request request_;
+    daemon_protocol::Reply reply_;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "MarketDataProvider.hpp"
+#include "SymbolTable.hpp"
+#include "quantis/feed/FeedProtocol.hpp"
+#include "quantis/feed/QuoteMessage.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Quote provider backed by a streaming feed such as quantis_feedsim.
+//
+// A background thread owns the socket and runs an epoll loop. It subscribes
+// to the tracked tickers and decodes each read buffer of updates in place
+// into a quote cache indexed by TickerId, under one lock per read. getQuotes()
+// only copies from the cache, so a tick never waits on the network. When the
+// connection drops, the thread reconnects with backoff and resubscribes.
+class FeedClient : public MarketDataProvider {
+public:
+    struct Stats {
+        std::uint64_t updates;
+        std::uint64_t missed; // updates the server dropped, from sequence gaps
+        std::uint64_t connects;
+        bool connected;
+    };
+
+    FeedClient(const SymbolTable &symbols, FeedEndpoint endpoint);
+    ~FeedClient() override;
+
+    FeedClient(const FeedClient &) = delete;
+    FeedClient &operator=(const FeedClient &) = delete;
+
+    // Resubscribes when the set of ids changed, then waits briefly for the
+    // first quote of each new ticker.
+    void beginTick(std::span<const TickerId> ids) override;
+
+    // Latest cached quote per id; all zero until the feed has sent one.
+    // Safe to call from several threads.
+    void getQuotes(std::span<const TickerId> ids, std::span<Quote> quotes) override;
+
+    Stats stats() const;
+
+private:
+    void run();
+    void wake();
+    void connect();
+    void fail(const char *operation, int error);
+    void disconnect();
+    bool flushOutput();
+    bool readUpdates();
+    void apply(quote_message::QuoteView update);
+    void queueSubscription();
+    void updateInterest();
+
+    const SymbolTable &symbols_;
+    FeedEndpoint endpoint_;
+
+    // Quote cache, shared by the I/O thread and getQuotes callers.
+    mutable std::shared_mutex cache_mutex_;
+    std::condition_variable_any cache_cv_;
+    std::vector<Quote> cache_;
+    std::vector<std::uint8_t> has_quote_;
+    std::vector<std::uint8_t> subscribed_;
+    std::size_t missing_{0}; // subscribed ids still waiting for a first quote
+
+    // Subscription handed from beginTick to the I/O thread.
+    std::mutex subscription_mutex_;
+    std::vector<TickerId> subscription_ids_;
+    std::string subscription_;
+    std::uint64_t subscription_version_{0};
+
+    // Owned by the I/O thread.
+    int epoll_fd_{-1};
+    int wake_fd_{-1};
+    int socket_fd_{-1};
+    bool connecting_{false};
+    bool want_write_{false};
+    std::uint64_t sent_version_{0};
+    std::chrono::milliseconds backoff_{0};
+    std::chrono::steady_clock::time_point retry_at_{};
+    bool reported_down_{false};
+    std::string output_;
+    std::size_t output_sent_{0};
+    std::vector<char> input_;
+    std::size_t input_size_{0};
+    std::uint64_t last_sequence_{0};
+    bool first_quotes_{false};
+
+    std::atomic_bool running_{true};
+    std::atomic<std::uint64_t> updates_{0};
+    std::atomic<std::uint64_t> missed_{0};
+    std::atomic<std::uint64_t> connects_{0};
+    std::atomic_bool connected_{false};
+    std::thread thread_;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Where a quote feed listens: "unix:PATH" for a Unix domain socket, or
+// "[tcp:]HOST:PORT" for TCP.
+struct FeedEndpoint {
+    enum class Kind { Tcp, Unix };
+
+    Kind kind{Kind::Tcp};
+    std::string host; // TCP: numeric IPv4 address or "localhost"
+    std::uint16_t port{0};
+    std::string path; // Unix: socket path
+
+    // Throws std::invalid_argument for a malformed endpoint.
+    static FeedEndpoint parse(std::string_view text);
+    std::string text() const;
+};
+
+// Both return a non-blocking socket, or -1 with errno set. connectFeed may
+// return while the connection is still in progress (EINPROGRESS).
+int listenFeed(const FeedEndpoint &endpoint);
+int connectFeed(const FeedEndpoint &endpoint);
+
+// Client to server, one command per '\n'-terminated line:
+//   RESET                 drop every subscription on this connection
+//   SUB <id> <symbol>     subscribe to `symbol`; updates carry the client's `id`
+//
+// Server to client: binary quote messages (QuoteMessage.hpp), numbered from 1
+// on each connection. An update dropped for a slow client still uses up its
+// sequence number, so the client can count what it missed. After a SUB the
+// server sends the ticker's latest quote straight away, then updates as they
+// are produced.
+namespace feed_protocol {
+
+void appendReset(std::string &out);
+void appendSubscribe(std::string &out, TickerId id, std::string_view symbol);
+
+enum class Command { Reset, Subscribe, Invalid };
+
+// Parses one line without its '\n'. `symbol` points into `line`.
+Command parseCommand(std::string_view line, TickerId &id, std::string_view &symbol);
+
+} // namespace feed_protocol
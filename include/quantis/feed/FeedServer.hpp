@@ -0,0 +1,81 @@
+#pragma once
+
+#include "SymbolTable.hpp"
+#include "quantis/feed/FeedProtocol.hpp"
+#include "quantis/feed/QuoteMessage.hpp"
+#include "quantis/sim/MarketSimulator.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Local quote feed for development and load tests, served by quantis_feedsim.
+//
+// Clients subscribe by symbol (see FeedProtocol.hpp). Every symbol any
+// client subscribed to is simulated by one MarketSimulator, and updates are
+// published round-robin over that universe at a fixed total rate, each sent
+// to every subscriber under the id that subscriber chose. A client that
+// cannot keep up has updates dropped rather than buffered without bound.
+class FeedServer {
+public:
+    struct Options {
+        FeedEndpoint endpoint;
+        double rate{100000}; // updates per second across all tickers; 0 = as fast as possible
+        std::uint64_t seed{1};
+    };
+
+    struct Stats {
+        std::uint64_t published;
+        std::uint64_t dropped;
+        std::size_t clients;
+        std::size_t tickers;
+    };
+
+    // Binds and listens; throws std::runtime_error on failure.
+    explicit FeedServer(Options options);
+    ~FeedServer();
+
+    FeedServer(const FeedServer &) = delete;
+    FeedServer &operator=(const FeedServer &) = delete;
+
+    // Serves clients on the calling thread until `running` turns false.
+    void run(const std::atomic_bool &running);
+
+    Stats stats() const;
+
+private:
+    struct Connection {
+        int fd{-1};
+        std::vector<TickerId> client_ids; // by server id; kInvalidId when not subscribed
+        std::string input;
+        std::string output;
+        std::size_t output_sent{0};
+        std::uint64_t sequence{0}; // of the last update sent or dropped
+        bool want_write{false};
+    };
+
+    void accept();
+    void close(Connection &connection);
+    bool readCommands(Connection &connection);
+    void subscribe(Connection &connection, TickerId client_id, std::string_view symbol);
+    bool flush(Connection &connection);
+    void publish(std::size_t count);
+
+    Options options_;
+    int listen_fd_{-1};
+    int epoll_fd_{-1};
+    std::vector<std::unique_ptr<Connection>> connections_;
+    SymbolTable symbols_;
+    MarketSimulator simulator_;
+    std::vector<Quote> last_;
+    std::vector<TickerId> step_ids_;
+    std::vector<Quote> step_quotes_;
+    TickerId cursor_{0};
+
+    std::atomic<std::uint64_t> published_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::size_t> client_count_{0};
+    std::atomic<std::size_t> ticker_count_{0};
+};
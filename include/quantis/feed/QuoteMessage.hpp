@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Types.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+
+// Binary quote update, the feed's server-to-client message.
+//
+// Layout (little-endian, 104 bytes, every field naturally aligned):
+//   0   MessageHeader  magic, version, type, length of the whole message
+//   8   u64            sequence number, per connection, starting at 1
+//   16  u32            ticker id
+//   20  u32            reserved, zero
+//   24  Quote          the numeric fields and source timestamp, in declaration order
+//
+// Messages are self-delimiting, so a stream of them can be decoded straight
+// out of a socket receive buffer or an mmapped file. Readers skip message
+// types they do not know by `length`, which leaves room to add types
+// without a version bump.
+namespace quote_message {
+
+static_assert(std::endian::native == std::endian::little,
+              "quote messages are read in place; big-endian hosts would need byte swapping");
+
+inline constexpr std::uint16_t kMagic = 0x5551; // "QU"
+inline constexpr std::uint8_t kVersion = 2; // 2: quotes carry a source timestamp
+
+enum class MessageType : std::uint8_t {
+    Quote = 1
+};
+
+struct MessageHeader {
+    std::uint16_t magic;
+    std::uint8_t version;
+    MessageType type;
+    std::uint32_t length;
+};
+
+inline constexpr std::size_t kSequenceOffset = sizeof(MessageHeader);
+inline constexpr std::size_t kTickerOffset = kSequenceOffset + sizeof(std::uint64_t);
+inline constexpr std::size_t kQuoteOffset = kTickerOffset + 2 * sizeof(std::uint32_t);
+inline constexpr std::size_t kQuoteMessageSize = kQuoteOffset + sizeof(Quote);
+
+static_assert(sizeof(MessageHeader) == 8);
+static_assert(sizeof(Quote) == 80 && kQuoteMessageSize == 104,
+              "Quote's layout is part of the wire format");
+
+// The header of every quote message read as one word, so the decoder's
+// common case is a single compare.
+inline constexpr std::uint64_t kQuoteHeaderWord =
+    std::uint64_t{kMagic} | std::uint64_t{kVersion} << 16 |
+    std::uint64_t{static_cast<std::uint8_t>(MessageType::Quote)} << 24 | std::uint64_t{kQuoteMessageSize} << 32;
+
+// Writes one quote message to `out`, which must have kQuoteMessageSize bytes.
+void encodeQuote(char *out, std::uint64_t sequence, TickerId id, const Quote &quote);
+void appendQuote(std::string &out, std::uint64_t sequence, TickerId id, const Quote &quote);
+
+// A quote message inside someone else's buffer. Accessors load straight from
+// the bytes, which need not be aligned; nothing is copied up front.
+class QuoteView {
+public:
+    explicit QuoteView(const char *data) : data_(data) {}
+
+    std::uint64_t sequence() const { return load<std::uint64_t>(kSequenceOffset); }
+    TickerId tickerId() const { return load<TickerId>(kTickerOffset); }
+    Quote quote() const { return load<Quote>(kQuoteOffset); }
+
+private:
+    template <typename T>
+    T load(std::size_t offset) const {
+        T value;
+        std::memcpy(&value, data_ + offset, sizeof(T));
+        return value;
+    }
+
+    const char *data_;
+};
+
+struct DecodeResult {
+    std::size_t consumed{0};  // bytes of complete messages
+    std::size_t messages{0};  // quote messages handed to the handler
+    bool malformed{false};    // stopped at bytes that are not a message
+};
+
+// Calls `handler(QuoteView)` for each complete quote message at the front of
+// `bytes`. A message cut off by the end of the buffer is left unconsumed:
+// keep bytes[consumed..] and present them again with what follows. Does not
+// allocate; views are only valid while `bytes` is.
+template <typename Handler>
+DecodeResult decode(std::span<const char> bytes, Handler &&handler) {
+    const char *cursor = bytes.data();
+    std::size_t left = bytes.size();
+    DecodeResult result;
+    while (left >= sizeof(MessageHeader)) {
+        std::uint64_t word;
+        std::memcpy(&word, cursor, sizeof(word));
+        if (word == kQuoteHeaderWord && left >= kQuoteMessageSize) [[likely]] {
+            handler(QuoteView(cursor));
+            ++result.messages;
+            cursor += kQuoteMessageSize;
+            left -= kQuoteMessageSize;
+            continue;
+        }
+
+        MessageHeader header;
+        std::memcpy(&header, cursor, sizeof(header));
+        if (header.magic != kMagic || header.version != kVersion || header.length < sizeof(MessageHeader) ||
+            (header.type == MessageType::Quote && header.length != kQuoteMessageSize)) {
+            result.malformed = true;
+            break;
+        }
+        if (header.length > left) break;
+        cursor += header.length;
+        left -= header.length;
+    }
+    result.consumed = bytes.size() - left;
+    return result;
+}
+
+} // namespace quote_message
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "quantis/filter/QuoteColumns.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A screener filter such as
+//
+//   price > 20 && daily_percent_change < -3 && volume > 2 * average_volume
+//
+// compiled once into stack bytecode and evaluated over QuoteColumns a batch
+// of rows at a time. Each instruction runs as a tight loop over the batch, so
+// the cost per row is a few arithmetic operations per instruction.
+//
+// Grammar, loosest binding first:
+//   expr       := and ('||' and)*
+//   and        := unary ('&&' unary)*
+//   unary      := '!' unary | comparison
+//   comparison := sum (('<' | '<=' | '>' | '>=' | '==' | '!=') sum)?
+//   sum        := product (('+' | '-') product)*
+//   product    := factor (('*' | '/') factor)*
+//   factor     := NUMBER | FIELD | '-' factor | '(' expr ')'
+// Numeric fields are the Quote members. Text fields (ticker, name, sector,
+// industry, notes, date_added) can only be compared with == or != against a
+// quoted string literal.
+class FilterExpression {
+public:
+    // Throws std::invalid_argument describing the first error and its offset.
+    static FilterExpression compile(std::string_view text);
+
+    // Replaces `selection` with the indices of matching rows, ascending.
+    void select(const QuoteColumns &columns, std::vector<std::uint32_t> &selection) const;
+
+    const std::string &text() const { return text_; }
+
+private:
+    enum class Op : std::uint8_t {
+        Column,
+        Constant,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Negate,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Equal,
+        NotEqual,
+        And,
+        Or,
+        Not,
+        TextEqual,
+        TextNotEqual
+    };
+
+    struct Instruction {
+        Op op;
+        std::uint8_t field;    // Column: NumericField, TextEqual/TextNotEqual: TextField
+        bool immediate;        // binary operator whose right operand is `value`
+        std::uint32_t literal; // TextEqual/TextNotEqual: index into literals_
+        double value;          // Constant, or the immediate operand
+    };
+
+    class Parser;
+
+    std::string text_;
+    std::vector<Instruction> code_;
+    std::vector<std::string> literals_;
+    std::size_t max_depth_{0};
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "SymbolTable.hpp"
+#include "Types.hpp"
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+enum class NumericField : std::uint8_t {
+    Price,
+    MarketCap,
+    DailyPercentChange,
+    Volume,
+    AverageVolume,
+    FiftyTwoWeekHigh,
+    FiftyTwoWeekLow,
+    Bid,
+    Ask,
+    Count
+};
+
+enum class TextField : std::uint8_t {
+    Ticker,
+    Name,
+    Sector,
+    Industry,
+    Notes,
+    DateAdded,
+    Count
+};
+
+inline constexpr std::size_t kNumericFieldCount = static_cast<std::size_t>(NumericField::Count);
+inline constexpr std::size_t kTextFieldCount = static_cast<std::size_t>(TextField::Count);
+
+// Structure-of-arrays copy of a screener table for filter evaluation.
+// Integer fields are widened to double, which is exact below 2^53. Text
+// columns point into the rows they were loaded from (and the symbol table's
+// names) and are only valid while those rows are alive and unchanged.
+struct QuoteColumns {
+    std::array<std::vector<double>, kNumericFieldCount> numeric;
+    std::array<std::vector<std::string_view>, kTextFieldCount> text;
+
+    void resize(std::size_t count);
+    // `name` is the display name the table shows for the row.
+    void set(std::size_t row, const TickerRecord &meta, const Quote &q, std::string_view name);
+    void load(const ScreenerRows &rows, const SymbolTable *names = nullptr);
+    std::size_t size() const { return numeric[0].size(); }
+
+    const std::vector<double> &operator[](NumericField field) const { return numeric[static_cast<std::size_t>(field)]; }
+    const std::vector<std::string_view> &operator[](TextField field) const { return text[static_cast<std::size_t>(field)]; }
+};
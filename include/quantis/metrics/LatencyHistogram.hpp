@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Fixed-bucket log-linear latency histogram over nanoseconds.
+//
+// Values below 2^kSubBucketBits ns get one bucket each. Above that, every
+// power of two is split into 2^(kSubBucketBits - 1) equal buckets, so a
+// bucket is never wider than about 3% of the values in it; anything from
+// 2^(kMaxExponent + 1) ns (about 37 minutes) up shares the last bucket.
+// Bucketing is a count-leading-zeros and two shifts, and the layout never
+// changes, so histograms from different threads or processes merge by
+// adding counts.
+namespace latency_histogram {
+
+inline constexpr unsigned kSubBucketBits = 6;
+inline constexpr unsigned kMaxExponent = 40;
+inline constexpr std::size_t kHalfSubBuckets = std::size_t{1} << (kSubBucketBits - 1);
+inline constexpr std::size_t kBuckets = (kMaxExponent - kSubBucketBits + 3) * kHalfSubBuckets;
+
+constexpr std::size_t bucketFor(std::uint64_t ns) {
+    if (ns < (std::uint64_t{1} << kSubBucketBits)) return static_cast<std::size_t>(ns);
+    unsigned exponent = 63u - static_cast<unsigned>(std::countl_zero(ns));
+    if (exponent > kMaxExponent) return kBuckets - 1;
+    unsigned shift = exponent - (kSubBucketBits - 1);
+    // (ns >> shift) is in [kHalfSubBuckets, 2 * kHalfSubBuckets).
+    return (shift + 1) * kHalfSubBuckets + static_cast<std::size_t>(ns >> shift) - kHalfSubBuckets;
+}
+
+// Largest value that maps to `bucket`.
+constexpr std::uint64_t bucketUpperBound(std::size_t bucket) {
+    if (bucket < (std::size_t{1} << kSubBucketBits)) return bucket;
+    std::size_t shift = bucket / kHalfSubBuckets - 1;
+    std::uint64_t first = (std::uint64_t{bucket % kHalfSubBuckets} + kHalfSubBuckets) << shift;
+    return first + (std::uint64_t{1} << shift) - 1;
+}
+
+static_assert(bucketFor((std::uint64_t{2} << kMaxExponent) - 1) == kBuckets - 1);
+static_assert(bucketFor(63) == 63 && bucketFor(64) == 64 && bucketFor(65) == 64 && bucketFor(66) == 65);
+static_assert(bucketUpperBound(bucketFor(1000)) >= 1000 && bucketFor(bucketUpperBound(bucketFor(1000))) == bucketFor(1000));
+
+} // namespace latency_histogram
+
+// Plain (single-threaded) histogram: what per-thread recorders merge into
+// and what summaries are computed from.
+class LatencyHistogram {
+public:
+    void record(std::uint64_t ns, std::uint64_t count = 1);
+    void merge(const LatencyHistogram &other);
+    void clear();
+
+    std::uint64_t count() const { return count_; }
+    std::uint64_t sum() const { return sum_; }
+    std::uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    // Upper bound of the bucket holding the q-quantile (0 < q <= 1), capped
+    // at the largest recorded value; 0 when empty.
+    std::uint64_t percentile(double q) const;
+
+    std::span<const std::uint64_t> buckets() const { return counts_; }
+
+    // Adds counts recorded elsewhere, e.g. by a per-thread recorder or read
+    // back from a file. `buckets` must have latency_histogram::kBuckets entries.
+    void add(std::span<const std::uint64_t> buckets, std::uint64_t sum, std::uint64_t max);
+
+private:
+    std::array<std::uint64_t, latency_histogram::kBuckets> counts_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t max_{0};
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "DoubleBuffer.hpp"
+#include "quantis/anomaly/Alerts.hpp"
+#include "quantis/metrics/StageMetrics.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// What a scrape reports: everything already reduced to numbers, so turning it
+// into text needs no access to the live metrics.
+struct MetricsSnapshot {
+    struct Summary {
+        double p50{0};
+        double p99{0};
+        double p999{0};
+        double sum{0}; // seconds
+        std::uint64_t count{0};
+    };
+
+    std::array<Summary, kStageCount> stages{};
+    std::array<std::uint64_t, kFrameCounterCount> frames{};
+    std::array<std::uint64_t, kAlertCount> alerts{};
+    std::uint64_t tracked_tickers{0};
+    double interval_seconds{0};
+    double uptime_seconds{0};
+
+    static MetricsSnapshot from(const StageMetrics::Snapshot &metrics, std::uint64_t tracked_tickers,
+                                double interval_seconds);
+};
+
+// Prometheus text exposition format (version 0.0.4) for `snapshot`, plus the
+// process's resident set size.
+void appendPrometheusText(std::string &out, const MetricsSnapshot &snapshot, std::uint64_t resident_bytes);
+
+// Resident set size from /proc/self/statm; 0 if it cannot be read.
+std::uint64_t residentBytes();
+
+// Serves GET /metrics on 127.0.0.1:port from a background thread.
+//
+// The realtime loop hands over snapshots with publish(), a copy into a
+// DoubleBuffer; the server thread only reads what was published, so a
+// scrape never waits on the loop or the loop on a scrape.
+class MetricsServer {
+public:
+    // Binds and starts serving; throws std::runtime_error on failure.
+    explicit MetricsServer(std::uint16_t port);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    // Single writer: call from one thread only.
+    void publish(const MetricsSnapshot &snapshot) { published_.publish(snapshot); }
+
+    std::uint16_t port() const { return port_; }
+
+private:
+    void serve();
+    void respond(int fd);
+
+    std::uint16_t port_;
+    int listen_fd_{-1};
+    int wake_fd_{-1};
+    DoubleBuffer<MetricsSnapshot> published_;
+    std::string response_;
+    std::thread thread_;
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Types.hpp"
+#include "quantis/anomaly/Alerts.hpp"
+#include "quantis/metrics/LatencyHistogram.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Where a realtime frame's time goes.
+enum class Stage : std::uint8_t {
+    Load,        // ticker list from Storage
+    Fetch,       // quotes from the provider
+    Evaluate,    // anomaly rules
+    Format,      // table layout into the renderer's buffer
+    Write,       // diff and write to the terminal
+    TickToAlert, // per quote: source timestamp to its alerts being known
+    TickJitter,  // per tick: how late the fetch started against its deadline
+    Count
+};
+
+enum class FrameCounter : std::uint8_t {
+    Fetched,   // ticks fetched
+    Skipped,   // ticks skipped because the previous one overran
+    Evaluated, // frames through anomaly evaluation
+    Dropped,   // evaluated frames replaced before they were drawn
+    Drawn,     // frames put on the terminal
+    Count
+};
+
+inline constexpr std::size_t kStageCount = static_cast<std::size_t>(Stage::Count);
+inline constexpr std::size_t kFrameCounterCount = static_cast<std::size_t>(FrameCounter::Count);
+
+std::string_view stageName(Stage stage);
+std::string_view frameCounterName(FrameCounter counter);
+
+// Per-stage latency histograms and frame and alert counters.
+//
+// Recording is lock-free: each recording thread gets its own slot on first
+// use and is its only writer, so an update is a relaxed load and store with
+// no read-modify-write. snapshot() sums every slot while recording goes on;
+// each counter it reads is exact, though a snapshot taken mid-frame may
+// include some of that frame's updates and not others.
+class StageMetrics {
+public:
+    struct Snapshot {
+        std::array<LatencyHistogram, kStageCount> stages;
+        std::array<std::uint64_t, kFrameCounterCount> frames{};
+        std::array<std::uint64_t, kAlertCount> alerts{};
+        double seconds{0};        // covered by the snapshot
+        std::int64_t taken_at{0}; // Unix seconds
+    };
+
+    StageMetrics();
+    ~StageMetrics();
+
+    StageMetrics(const StageMetrics &) = delete;
+    StageMetrics &operator=(const StageMetrics &) = delete;
+
+    void record(Stage stage, std::chrono::nanoseconds elapsed) {
+        local().record(stage, elapsed.count() > 0 ? static_cast<std::uint64_t>(elapsed.count()) : 0);
+    }
+    void count(FrameCounter counter, std::uint64_t n = 1) { Slot::add(local().frames[index(counter)], n); }
+
+    // Tick-to-alert for a batch of quotes whose alerts became known at
+    // `now_ns` (Unix epoch), plus the alerts they raised. Quotes without a
+    // source timestamp are not timed.
+    void recordAlerts(std::span<const Quote> quotes, std::span<const AlertSet> alerts, std::int64_t now_ns);
+
+    std::unique_ptr<Snapshot> snapshot() const;
+
+private:
+    struct Slot {
+        std::array<std::array<std::atomic<std::uint64_t>, latency_histogram::kBuckets>, kStageCount> buckets;
+        std::array<std::atomic<std::uint64_t>, kStageCount> sums;
+        std::array<std::atomic<std::uint64_t>, kStageCount> maxes;
+        std::array<std::atomic<std::uint64_t>, kFrameCounterCount> frames;
+        std::array<std::atomic<std::uint64_t>, kAlertCount> alerts;
+        Slot *next{nullptr};
+
+        static void add(std::atomic<std::uint64_t> &counter, std::uint64_t n) {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+        void record(Stage stage, std::uint64_t ns) {
+            std::size_t s = index(stage);
+            add(buckets[s][latency_histogram::bucketFor(ns)], 1);
+            add(sums[s], ns);
+            if (ns > maxes[s].load(std::memory_order_relaxed)) maxes[s].store(ns, std::memory_order_relaxed);
+        }
+    };
+
+    template <typename Enum>
+    static constexpr std::size_t index(Enum value) {
+        return static_cast<std::size_t>(value);
+    }
+
+    Slot &local();
+    Slot &registerThread();
+
+    std::uint64_t id_;
+    std::chrono::steady_clock::time_point start_;
+    std::atomic<Slot *> slots_{nullptr};
+};
+
+// Human-readable summary: p50/p99/p999/max per stage and the counters.
+void printSummary(std::ostream &out, const StageMetrics::Snapshot &snapshot);
+
+// The stats file kept from the last realtime session. Both return false if
+// the file cannot be written or read; loading also rejects files written
+// with a different histogram layout.
+bool saveSnapshot(const std::string &path, const StageMetrics::Snapshot &snapshot);
+bool loadSnapshot(const std::string &path, StageMetrics::Snapshot &snapshot);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Reproducible synthetic market. Every ticker keeps its own state between
+// ticks:
+//   - price follows geometric Brownian motion with a per-ticker drift and
+//     volatility, plus rare shock jumps;
+//   - the bid/ask spread mean-reverts to a per-ticker base and blows out on
+//     shocks;
+//   - volume accumulates over a 390-minute session along a U-shaped intraday
+//     curve, runs hot for a while after a shock, and resets each day,
+//     feeding an average daily volume;
+//   - the 52-week range tracks the path's running high and low.
+// One tick is one simulated minute.
+//
+// Randomness comes from a counter-based generator keyed by (seed, ticker,
+// tick), so a ticker's path depends only on the seed and not on how tickers
+// are batched or split across threads. Quotes are generated a batch at a
+// time in structure-of-arrays loops the compiler vectorizes.
+class MarketSimulator {
+public:
+    explicit MarketSimulator(std::uint64_t seed);
+
+    // Starts the next tick for tickers with ids below `universe`. Tickers seen
+    // for the first time are seeded from their id. Not thread-safe.
+    void advance(std::size_t universe);
+
+    // Seeds any tickers below `universe` not seen yet, without starting a
+    // tick. Not thread-safe.
+    void extend(std::size_t universe);
+
+    // Writes this tick's quote for each id into `quotes`. Ids must be below
+    // the last advance() universe. Safe to call from several threads at once
+    // for disjoint ids.
+    void step(std::span<const TickerId> ids, std::span<Quote> quotes);
+
+    // Writes each ticker's latest quote without moving it forward. Ids must
+    // already be seeded.
+    void current(std::span<const TickerId> ids, std::span<Quote> quotes) const;
+
+    std::uint64_t seed() const { return seed_; }
+    std::uint64_t tick() const { return tick_; }
+
+private:
+    struct TickerState {
+        std::uint64_t key;
+        double price;
+        double drift;      // per-minute log drift, Ito-corrected
+        double volatility; // per-minute log volatility
+        double spread;
+        double base_spread; // target spread as a fraction of price
+        double day_open;
+        double day_volume;
+        double average_volume;
+        double high;
+        double low;
+        double shares;
+        double activity; // extra volume rate after a shock, decaying
+    };
+
+    TickerState initialState(TickerId id) const;
+    static Quote quoteFor(const TickerState &state);
+
+    std::uint64_t seed_;
+    std::uint64_t tick_{0};
+    std::vector<TickerState> state_;
+};
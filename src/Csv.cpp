@@ -0,0 +1,70 @@
+#include "Csv.hpp"
+#include <charconv>
+
+void splitCsvLine(std::string_view line, std::vector<std::string> &fields) {
+    fields.clear();
+    std::string field;
+    bool quoted = false;
+    for (std::size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(std::move(field));
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields.push_back(std::move(field));
+}
+
+void CsvFormatter::separator() {
+    if (row_started_) out_ += ',';
+    row_started_ = true;
+}
+
+void CsvFormatter::field(std::string_view text) {
+    separator();
+    out_ += '"';
+    std::size_t start = 0;
+    for (std::size_t quote = text.find('"'); quote != std::string_view::npos; quote = text.find('"', start)) {
+        out_.append(text.substr(start, quote + 1 - start));
+        out_ += '"';
+        start = quote + 1;
+    }
+    out_.append(text.substr(start));
+    out_ += '"';
+}
+
+void CsvFormatter::field(double value) {
+    separator();
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+    out_ += '"';
+    out_.append(digits, result.ptr);
+    out_ += '"';
+}
+
+void CsvFormatter::field(long long value) {
+    separator();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out_ += '"';
+    out_.append(digits, result.ptr);
+    out_ += '"';
+}
+
+void CsvFormatter::endRow() {
+    out_ += '\n';
+    row_started_ = false;
+}
@@ -0,0 +1,140 @@
+#include "ReplayReader.hpp"
+#include "Csv.hpp"
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+bool isArchive(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(tick_archive::kMagic)] = {};
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, tick_archive::kMagic, sizeof(magic)) == 0;
+}
+
+template <typename T>
+bool parseField(const std::string &text, T &value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// Volumes are written as integers, but accept floating notation too.
+bool parseCount(const std::string &text, long long &value) {
+    if (parseField(text, value)) return true;
+    double as_double = 0.0;
+    if (!parseField(text, as_double)) return false;
+    value = static_cast<long long>(as_double);
+    return true;
+}
+
+constexpr std::size_t kCsvColumns = 15;
+}
+
+ReplayReader::ReplayReader(const std::string &path, std::int64_t csv_tick_interval_ns)
+    : csv_interval_ns_(csv_tick_interval_ns) {
+    if (isArchive(path)) {
+        archive_ = std::make_unique<TickArchiveReader>(path);
+        return;
+    }
+
+    csv_.open(path);
+    if (!csv_.is_open()) {
+        throw std::runtime_error("Unable to open replay file: " + path);
+    }
+}
+
+const SymbolTable &ReplayReader::symbols() const { return symbols_; }
+
+bool ReplayReader::next(ReplayTick &tick) {
+    tick.ids.clear();
+    tick.quotes.clear();
+    return archive_ ? nextFromArchive(tick) : nextFromCsv(tick);
+}
+
+bool ReplayReader::nextFromArchive(ReplayTick &tick) {
+    const auto &blocks = archive_->blocks();
+    bool started = false;
+    while (block_ < blocks.size()) {
+        const auto &block = blocks[block_];
+        for (; row_ < block.size(); ++row_) {
+            if (started && block.timestamp[row_] != tick.timestamp_ns) return true;
+            if (!started) {
+                tick.timestamp_ns = block.timestamp[row_];
+                started = true;
+            }
+            TickerId recorded = block.ticker[row_];
+            if (recorded >= archive_->symbolCount()) continue; // damaged row
+            if (recorded >= archive_ids_.size()) {
+                archive_ids_.resize(archive_->symbolCount(), SymbolTable::kInvalidId);
+            }
+            if (archive_ids_[recorded] == SymbolTable::kInvalidId) {
+                archive_ids_[recorded] = symbols_.intern(archive_->symbol(recorded));
+            }
+            tick.ids.push_back(archive_ids_[recorded]);
+            tick.quotes.push_back(block.quote(row_));
+        }
+        ++block_;
+        row_ = 0;
+    }
+    return started;
+}
+
+bool ReplayReader::nextFromCsv(ReplayTick &tick) {
+    ++csv_tick_;
+    tick.timestamp_ns = static_cast<std::int64_t>(csv_tick_ - 1) * csv_interval_ns_;
+
+    auto take = [&](TickerId id, const Quote &quote) {
+        if (id >= seen_in_tick_.size()) {
+            seen_in_tick_.resize(static_cast<std::size_t>(id) + 1, 0);
+        }
+        if (seen_in_tick_[id] == csv_tick_) return false;
+        seen_in_tick_[id] = csv_tick_;
+        tick.ids.push_back(id);
+        tick.quotes.push_back(quote);
+        return true;
+    };
+
+    if (has_pending_) {
+        take(pending_id_, pending_quote_);
+        has_pending_ = false;
+    }
+
+    TickerId id{};
+    Quote quote;
+    while (readCsvRow(id, quote)) {
+        if (!take(id, quote)) {
+            // Ticker repeated: it opens the next tick.
+            pending_id_ = id;
+            pending_quote_ = quote;
+            has_pending_ = true;
+            break;
+        }
+    }
+    return !tick.ids.empty();
+}
+
+bool ReplayReader::readCsvRow(TickerId &id, Quote &quote) {
+    while (std::getline(csv_, line_)) {
+        if (!line_.empty() && line_.back() == '\r') line_.pop_back();
+        // Header lines may repeat when several exports are concatenated.
+        if (line_.empty() || line_.rfind("ticker,", 0) == 0) continue;
+
+        splitCsvLine(line_, fields_);
+        if (fields_.size() < kCsvColumns) {
+            throw std::runtime_error("Malformed replay row (expected " + std::to_string(kCsvColumns) +
+                                     " columns): " + line_);
+        }
+        bool ok = parseField(fields_[6], quote.price) && parseField(fields_[7], quote.market_cap) &&
+                  parseField(fields_[8], quote.daily_percent_change) && parseCount(fields_[9], quote.volume) &&
+                  parseCount(fields_[10], quote.average_volume) && parseField(fields_[11], quote.fiftytwo_week_high) &&
+                  parseField(fields_[12], quote.fiftytwo_week_low) && parseField(fields_[13], quote.bid) &&
+                  parseField(fields_[14], quote.ask);
+        if (!ok) {
+            throw std::runtime_error("Malformed replay row: " + line_);
+        }
+        id = symbols_.intern(fields_[0]);
+        symbols_.setName(id, fields_[1]);
+        return true;
+    }
+    return false;
+}
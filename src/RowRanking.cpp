@@ -0,0 +1,111 @@
+#include "RowRanking.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+// Rows ranked beyond the requested page, at least this many.
+constexpr std::size_t kMinSlack = 64;
+
+std::size_t rankedDepth(std::size_t limit, std::size_t available) {
+    return std::min(available, limit + std::max(limit, kMinSlack));
+}
+}
+
+RowRanking::RowRanking(SortKey key) : key_(key) {}
+
+std::span<const std::uint32_t> RowRanking::select(const ScreenerRows &rows, const std::vector<AlertSet> &alerts,
+                                                  std::size_t begin, std::size_t end) {
+    std::size_t count = rows.size();
+    end = std::min(end, count);
+    begin = std::min(begin, end);
+
+    if (keys_.size() != count) {
+        // Rows were added, removed or filtered out. Last tick's ranked rows
+        // only seed the candidates, so any that still exist remain useful.
+        keys_.resize(count);
+        is_ranked_.assign(count, 0);
+        std::erase_if(ranked_, [count](std::uint32_t i) { return i >= count; });
+        for (std::uint32_t i : ranked_) is_ranked_[i] = 1;
+    }
+    if (key_ == SortKey::Ticker) {
+        ranked_.resize(end);
+        std::iota(ranked_.begin(), ranked_.end(), 0u);
+        return std::span<const std::uint32_t>(ranked_).subspan(begin, end - begin);
+    }
+
+    loadKeys(rows, alerts);
+    std::size_t limit = end;
+    if (limit == 0) return {};
+
+    // Every row whose key is below the cutoff now is left out of the
+    // candidates. If the limit-th best candidate still reaches the cutoff, no
+    // excluded row can outrank it and the candidates hold the exact answer.
+    // Keeping some rows beyond the page keeps the cutoff low enough that
+    // a few ranked rows falling back does not force a full pass.
+    bool exact = false;
+    if (!ranked_.empty()) {
+        candidates_.assign(ranked_.begin(), ranked_.end());
+        for (std::uint32_t i = 0; i < count; ++i) {
+            if (!is_ranked_[i] && keys_[i] >= cutoff_) candidates_.push_back(i);
+        }
+        exact = candidates_.size() >= limit && rankCandidates(limit) >= cutoff_;
+    }
+    if (!exact) {
+        candidates_.resize(count);
+        std::iota(candidates_.begin(), candidates_.end(), 0u);
+        rankCandidates(limit);
+    }
+
+    std::size_t keep = rankedDepth(limit, candidates_.size());
+    for (std::uint32_t i : ranked_) is_ranked_[i] = 0;
+    ranked_.assign(candidates_.begin(), candidates_.begin() + static_cast<std::ptrdiff_t>(keep));
+    for (std::uint32_t i : ranked_) is_ranked_[i] = 1;
+    // Only the page is sorted; the slack past it is in no particular order.
+    cutoff_ = keys_[ranked_.front()];
+    for (std::uint32_t i : ranked_) cutoff_ = std::min(cutoff_, keys_[i]);
+    return std::span<const std::uint32_t>(ranked_).subspan(begin, end - begin);
+}
+
+// Moves the best limit + slack candidates to the front with the first
+// `limit` of them sorted, and returns the key at rank `limit`.
+double RowRanking::rankCandidates(std::size_t limit) {
+    auto by_rank = [this](std::uint32_t a, std::uint32_t b) { return better(a, b); };
+    std::size_t keep = rankedDepth(limit, candidates_.size());
+    auto first = candidates_.begin();
+    std::nth_element(first, first + static_cast<std::ptrdiff_t>(keep - 1), candidates_.end(), by_rank);
+    std::partial_sort(first, first + static_cast<std::ptrdiff_t>(limit), first + static_cast<std::ptrdiff_t>(keep), by_rank);
+    return keys_[candidates_[limit - 1]];
+}
+
+void RowRanking::loadKeys(const ScreenerRows &rows, const std::vector<AlertSet> &alerts) {
+    constexpr double kWorst = -std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const Quote &q = rows[i].second;
+        double key = 0.0;
+        switch (key_) {
+        case SortKey::PercentChange:
+            key = std::fabs(q.daily_percent_change);
+            break;
+        case SortKey::Volume:
+            key = static_cast<double>(q.volume);
+            break;
+        case SortKey::Spread:
+            key = q.ask - q.bid;
+            break;
+        case SortKey::Alerts:
+            key = i < alerts.size() ? std::popcount(alerts[i]) : 0;
+            break;
+        case SortKey::Ticker:
+            break;
+        }
+        keys_[i] = std::isnan(key) ? kWorst : key;
+    }
+}
+
+bool RowRanking::better(std::uint32_t a, std::uint32_t b) const {
+    if (keys_[a] != keys_[b]) return keys_[a] > keys_[b];
+    return a < b;
+}
@@ -1,9 +1,29 @@
 #include "ScreenerEngine.hpp"
+#include "Csv.hpp"
+#include "ReplayReader.hpp"
+#include "SpscQueue.hpp"
+#include "SyntheticMarketData.hpp"
 #include "Types.hpp"
+#include "quantis/anomaly/AnomalySnapshot.hpp"
+#include "quantis/daemon/DaemonClient.hpp"
+#include "quantis/daemon/DaemonServer.hpp"
+#include "quantis/feed/FeedClient.hpp"
+#include "quantis/metrics/MetricsServer.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <chrono>
 #include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
+#include <unistd.h>
 
 namespace {
 std::vector<std::string> sliceArgs(int argc, char **argv, int start) {
@@ -14,6 +34,152 @@ std::vector<std::string> sliceArgs(int argc, char **argv, int start) {
     return args;
 }
 
+// Removes "FLAG VALUE" from args and returns VALUE, if the flag is present.
+std::optional<std::string> takeOption(std::vector<std::string> &args, const std::string &flag) {
+    auto it = std::find(args.begin(), args.end(), flag);
+    if (it == args.end()) return std::nullopt;
+    if (std::next(it) == args.end()) {
+        throw std::invalid_argument("Missing value for " + flag);
+    }
+    std::string value = *std::next(it);
+    args.erase(it, it + 2);
+    return value;
+}
+
+std::size_t parseCount(const std::string &value, const std::string &flag) {
+    std::size_t pos = 0;
+    unsigned long parsed = 0;
+    try {
+        parsed = std::stoul(value, &pos);
+    } catch (const std::exception &) {
+        pos = 0;
+    }
+    if (pos != value.size() || parsed == 0) {
+        throw std::invalid_argument("Invalid value for " + flag + ": " + value);
+    }
+    return parsed;
+}
+
+// Unlike counts, a seed may be zero.
+std::uint64_t parseSeed(const std::string &value) {
+    std::size_t pos = 0;
+    unsigned long long parsed = 0;
+    try {
+        parsed = std::stoull(value, &pos);
+    } catch (const std::exception &) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != value.size() || value.front() == '-') {
+        throw std::invalid_argument("Invalid value for --seed: " + value);
+    }
+    return parsed;
+}
+
+// Parses a replay speed such as "10x", "0.5" or "max" (returned as 0).
+double parseSpeed(const std::string &value) {
+    if (value == "max") return 0.0;
+    std::string number = value;
+    if (!number.empty() && (number.back() == 'x' || number.back() == 'X')) number.pop_back();
+    std::size_t pos = 0;
+    double speed = 0.0;
+    try {
+        speed = std::stod(number, &pos);
+    } catch (const std::exception &) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != number.size() || !(speed > 0.0)) {
+        throw std::invalid_argument("Invalid value for --speed: " + value);
+    }
+    return speed;
+}
+
+RepaintMode parseRepaint(const std::string &value) {
+    if (value == "full") return RepaintMode::Full;
+    if (value == "diff") return RepaintMode::Diff;
+    throw std::invalid_argument("Invalid value for --repaint: " + value + " (expected full or diff)");
+}
+
+SortKey parseSortKey(const std::string &value) {
+    if (value == "ticker") return SortKey::Ticker;
+    if (value == "pct") return SortKey::PercentChange;
+    if (value == "volume") return SortKey::Volume;
+    if (value == "spread") return SortKey::Spread;
+    if (value == "alerts") return SortKey::Alerts;
+    throw std::invalid_argument("Invalid value for --sort: " + value + " (expected pct, volume, spread or alerts)");
+}
+
+// Returns std::cin for "-", otherwise opens `path` into `file`.
+std::istream *openInput(const std::string &path, std::ifstream &file) {
+    if (path == "-") return &std::cin;
+    file.open(path);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file for reading: " << path << "\n";
+        return nullptr;
+    }
+    return &file;
+}
+
+std::string trim(std::string_view text) {
+    auto begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) return {};
+    auto end = text.find_last_not_of(" \t\r");
+    return std::string(text.substr(begin, end - begin + 1));
+}
+
+// Reads "SYMBOL[,name,sector,industry,notes]" lines, skipping blank lines,
+// '#' comments and a leading "ticker,..." header so exports re-import as-is.
+class SymbolFileReader {
+public:
+    explicit SymbolFileReader(std::istream &in) : in_(in) {}
+
+    bool next(std::vector<std::string> &fields) {
+        while (std::getline(in_, line_)) {
+            bool first = first_line_;
+            first_line_ = false;
+            std::string_view view(line_);
+            if (!view.empty() && view.back() == '\r') view.remove_suffix(1);
+            if (view.find_first_not_of(" \t") == std::string_view::npos || view.front() == '#') continue;
+
+            splitCsvLine(view, fields);
+            for (auto &field : fields) {
+                field = trim(field);
+            }
+            if (fields[0].empty()) continue;
+            if (first && (fields[0] == "ticker" || fields[0] == "TICKER")) continue;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::istream &in_;
+    std::string line_;
+    bool first_line_{true};
+};
+
+struct Frame {
+    ScreenerRows rows;
+    std::vector<AlertSet> alerts;
+};
+
+constexpr std::size_t kStageQueueDepth = 4;
+constexpr auto kMinInterval = std::chrono::milliseconds(50);
+// Stage timings of the last realtime session, for 'screener stats'.
+constexpr const char *kStatsFile = "quantis_stats.bin";
+// Anomaly windows, checkpointed while alerts are evaluated and restored by
+// the next realtime view or daemon so its alerts start warm.
+constexpr const char *kAnomalySnapshotFile = "quantis_anomaly.bin";
+constexpr auto kAnomalyCheckpointPeriod = std::chrono::seconds(30);
+// Older checkpoints describe a different market session; start cold instead.
+constexpr auto kAnomalySnapshotMaxAge = std::chrono::hours(1);
+constexpr std::string_view kNoTickersMessage = "No tickers tracked. Add one with 'quantis screener add SYMBOL'.\n";
+// Where 'quantis daemon' listens, next to the database it serves.
+constexpr const char *kDaemonSocket = "quantis.sock";
+// Options that configure the engine itself. A command given any of them
+// runs locally rather than being answered by a daemon set up differently.
+constexpr std::array<const char *, 7> kEngineOptions{"--threads", "--seed",     "--feed",        "--record",
+                                                     "--repaint", "--interval", "--metrics-port"};
+
 std::atomic_bool *g_running_flag = nullptr;
 
 void handleSignal(int) {
@@ -24,23 +190,38 @@ void handleSignal(int) {
 }
 
 ScreenerEngine::ScreenerEngine(Storage &storage, MarketDataProvider &provider, TableRenderer &renderer)
-    : storage_(storage), provider_(provider), renderer_(renderer) {
-    owned_anomaly_ = std::make_unique<AnomalyEngine>();
-    anomaly_ = owned_anomaly_.get();
+    : storage_(storage), provider_(&provider), renderer_(renderer) {
+    configureWorkers(1);
 }
 
-ScreenerEngine::ScreenerEngine(Storage &storage, MarketDataProvider &provider, TableRenderer &renderer, AnomalyEngine &anomaly)
-    : storage_(storage), provider_(provider), renderer_(renderer), anomaly_(&anomaly) {}
+ScreenerEngine::~ScreenerEngine() { awaitCheckpoint(); }
 
 int ScreenerEngine::run(int argc, char **argv) {
     if (argc < 2) {
         std::cout << "Usage: quantis screener <command> [options]\n"
+                  << "       quantis daemon [--threads N] [--seed N|--feed ENDPOINT] [--interval MS] [--record FILE]\n"
+                  << "                      [--metrics-port PORT]\n"
                   << "Commands:\n"
                   << "  list [realtime]\n"
                   << "  alerts [list|realtime|clear]\n"
                   << "  add SYMBOL\n"
-                  << "  remove SYMBOL\n"
-                  << "  export csv\n";
+                  << "  remove SYMBOL | remove --from FILE|-\n"
+                  << "  import FILE|-\n"
+                  << "  replay FILE [--speed Nx|max]\n"
+                  << "  export csv [--out PATH|-]\n"
+                  << "  stats\n"
+                  << "Options:\n"
+                  << "  --threads N          fetch and evaluate quotes on N worker threads\n"
+                  << "  --seed N             simulated market: reproducible per-ticker price, spread and volume paths\n"
+                  << "  --feed ENDPOINT      stream quotes from a feed server (HOST:PORT or unix:PATH), e.g. quantis_feedsim\n"
+                  << "  --interval MS        realtime refresh period in milliseconds (default 1000, min 50)\n"
+                  << "  --metrics-port PORT  realtime: serve Prometheus metrics on http://127.0.0.1:PORT/metrics\n"
+                  << "  --record FILE        append every fetched tick to a binary columnar archive\n"
+                  << "  --repaint full|diff  realtime redraw: clear and reprint, or rewrite only changed cells (default diff)\n"
+                  << "  --where EXPR         keep only rows matching EXPR, e.g. \"price > 20 && volume > 2 * average_volume\"\n"
+                  << "  --sort KEY           rank list and alerts views by pct, volume, spread or alerts\n"
+                  << "  --top N              show only the N best-ranked rows\n"
+                  << "  --page K             show ranks (K-1)*N+1 to K*N; requires --top\n";
         return 1;
     }
 
@@ -48,12 +229,76 @@ int ScreenerEngine::run(int argc, char **argv) {
     if (command == "screener") {
         return handleScreener(sliceArgs(argc, argv, 2));
     }
+    if (command == "daemon") {
+        return handleDaemon(sliceArgs(argc, argv, 2));
+    }
 
     std::cerr << "Unknown command: " << command << "\n";
     return 1;
 }
 
-int ScreenerEngine::handleScreener(const std::vector<std::string> &args) {
+bool ScreenerEngine::applyOptions(std::vector<std::string> &args) {
+    try {
+        if (auto threads = takeOption(args, "--threads")) {
+            configureWorkers(parseCount(*threads, "--threads"));
+        }
+        if (auto seed = takeOption(args, "--seed")) {
+            simulator_ = std::make_unique<MarketSimulator>(parseSeed(*seed));
+            auto synthetic = std::make_unique<SyntheticMarketData>(storage_.symbols());
+            synthetic->setSimulator(simulator_.get());
+            useProvider(std::move(synthetic));
+        }
+        if (auto feed = takeOption(args, "--feed")) {
+            if (simulator_) {
+                throw std::invalid_argument("--feed and --seed cannot be combined; pass --seed to quantis_feedsim");
+            }
+            useProvider(std::make_unique<FeedClient>(storage_.symbols(), FeedEndpoint::parse(*feed)));
+        }
+        if (auto port = takeOption(args, "--metrics-port")) {
+            std::size_t parsed = parseCount(*port, "--metrics-port");
+            if (parsed > 65535) {
+                throw std::invalid_argument("Invalid value for --metrics-port: " + *port);
+            }
+            metrics_port_ = static_cast<std::uint16_t>(parsed);
+        }
+        if (auto record = takeOption(args, "--record")) {
+            recorder_ = std::make_unique<TickArchiveWriter>(*record);
+        }
+        if (auto repaint = takeOption(args, "--repaint")) {
+            repaint_ = parseRepaint(*repaint);
+        }
+        if (auto where = takeOption(args, "--where")) {
+            filter_ = FilterExpression::compile(*where);
+        }
+        if (auto sort = takeOption(args, "--sort")) {
+            view_.sort = parseSortKey(*sort);
+        }
+        if (auto top = takeOption(args, "--top")) {
+            view_.top = parseCount(*top, "--top");
+        }
+        if (auto page = takeOption(args, "--page")) {
+            view_.page = parseCount(*page, "--page");
+            if (view_.top == 0) {
+                throw std::invalid_argument("--page requires --top");
+            }
+        }
+        if (auto interval = takeOption(args, "--interval")) {
+            interval_ = std::chrono::milliseconds(parseCount(*interval, "--interval"));
+            if (interval_ < kMinInterval) {
+                throw std::invalid_argument("--interval must be at least " + std::to_string(kMinInterval.count()) + " ms");
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return false;
+    }
+    return true;
+}
+
+int ScreenerEngine::handleScreener(std::vector<std::string> args) {
+    if (!applyOptions(args)) {
+        return 1;
+    }
     if (args.empty()) {
         std::cerr << "Missing screener subcommand\n";
         return 1;
@@ -76,150 +321,886 @@ int ScreenerEngine::handleScreener(const std::vector<std::string> &args) {
             return handleAlerts(true, false);
         }
         if (mode == "clear") {
-            return handleAlertsClear();
+            return handleAlertsClear(std::cout, std::cerr);
         }
         std::cerr << "Unknown alerts subcommand: " << mode << "\n";
         return 1;
     }
+    if (sub == "stats") {
+        return handleStats();
+    }
     if (sub == "add") {
         if (args.size() < 2) {
             std::cerr << "Usage: quantis screener add SYMBOL\n";
             return 1;
         }
-        return handleAdd(args[1]);
+        return handleAdd(args[1], std::cout, std::cerr);
     }
     if (sub == "remove") {
+        if (args.size() >= 2 && args[1] == "--from") {
+            if (args.size() < 3) {
+                std::cerr << "Usage: quantis screener remove --from FILE|-\n";
+                return 1;
+            }
+            return handleBulkRemove(args[2]);
+        }
         if (args.size() < 2) {
             std::cerr << "Usage: quantis screener remove SYMBOL\n";
             return 1;
         }
-        return handleRemove(args[1]);
+        return handleRemove(args[1], std::cout, std::cerr);
+    }
+    if (sub == "replay") {
+        double speed = 1.0;
+        try {
+            if (auto value = takeOption(args, "--speed")) {
+                speed = parseSpeed(*value);
+            }
+        } catch (const std::exception &ex) {
+            std::cerr << ex.what() << "\n";
+            return 1;
+        }
+        if (args.size() < 2) {
+            std::cerr << "Usage: quantis screener replay FILE [--speed Nx|max]\n";
+            return 1;
+        }
+        return handleReplay(args[1], speed);
+    }
+    if (sub == "import") {
+        if (args.size() < 2) {
+            std::cerr << "Usage: quantis screener import FILE|-\n";
+            return 1;
+        }
+        return handleImport(args[1]);
     }
     if (sub == "export") {
+        std::optional<std::string> out;
+        try {
+            out = takeOption(args, "--out");
+        } catch (const std::exception &ex) {
+            std::cerr << ex.what() << "\n";
+            return 1;
+        }
         if (args.size() < 2 || args[1] != "csv") {
-            std::cerr << "Usage: quantis screener export csv\n";
+            std::cerr << "Usage: quantis screener export csv [--out PATH|-]\n";
             return 1;
         }
-        return handleExport();
+        return handleExport(out.value_or("quantis_export.csv"));
     }
 
     std::cerr << "Unknown screener subcommand: " << sub << "\n";
     return 1;
 }
 
+void ScreenerEngine::useProvider(std::unique_ptr<MarketDataProvider> provider) {
+    owned_provider_ = std::move(provider);
+    provider_ = owned_provider_.get();
+    configureWorkers(pool_->size());
+}
+
+// Providers that draw random numbers get one instance per worker; shared
+// providers (such as a feed cache) serve every worker. Anomaly evaluation
+// gets one shard per worker.
+void ScreenerEngine::configureWorkers(std::size_t threads) {
+    pool_.reset();
+    worker_providers_.clear();
+    std::random_device seeds;
+    for (std::size_t w = 1; w < threads; ++w) {
+        auto provider = provider_->forWorker(seeds());
+        if (!provider) {
+            worker_providers_.clear();
+            break;
+        }
+        worker_providers_.push_back(std::move(provider));
+    }
+    pool_ = std::make_unique<WorkerPool>(threads);
+    if (!anomaly_ || anomaly_->shards() != threads) {
+        anomaly_ = std::make_unique<ShardedAnomalyEngine>(threads);
+    }
+}
+
+MarketDataProvider &ScreenerEngine::providerFor(std::size_t worker) {
+    return worker == 0 || worker_providers_.empty() ? *provider_ : *worker_providers_[worker - 1];
+}
+
 ScreenerRows ScreenerEngine::collectRows() {
-    ScreenerRows rows;
-    for (const auto &ticker : storage_.listTickers()) {
-        rows.emplace_back(ticker, provider_.getQuote(ticker.ticker));
+    auto load_start = std::chrono::steady_clock::now();
+    TickerSnapshot snapshot = storage_.listTickers();
+    const auto &tickers = *snapshot;
+    auto fetch_start = std::chrono::steady_clock::now();
+    metrics_.record(Stage::Load, fetch_start - load_start);
+    tracked_tickers_.store(tickers.size(), std::memory_order_relaxed);
+
+    ScreenerRows rows(tickers.size());
+    rows.tickers = std::move(snapshot);
+    fetch_ids_.resize(tickers.size());
+    fetch_quotes_.resize(tickers.size());
+    if (filter_) {
+        filter_columns_.resize(rows.size());
+    }
+    for (std::size_t i = 0; i < tickers.size(); ++i) {
+        fetch_ids_[i] = tickers[i].id;
+    }
+    provider_->beginTick(fetch_ids_);
+
+    const auto &names = storage_.symbols();
+    pool_->parallelFor(tickers.size(), [&](std::size_t worker, std::size_t begin, std::size_t end) {
+        std::span<const TickerId> ids(fetch_ids_.data() + begin, end - begin);
+        std::span<Quote> quotes(fetch_quotes_.data() + begin, end - begin);
+        providerFor(worker).getQuotes(ids, quotes);
+        for (std::size_t i = begin; i < end; ++i) {
+            rows[i].first = &tickers[i];
+            rows[i].second = fetch_quotes_[i];
+            if (filter_) {
+                const auto &meta = tickers[i];
+                filter_columns_.set(i, meta, rows[i].second, names.displayName(meta.id, meta.name));
+            }
+        }
+    });
+    metrics_.record(Stage::Fetch, std::chrono::steady_clock::now() - fetch_start);
+
+    if (recorder_) {
+        auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+        for (const auto &row : rows) {
+            recorder_->append(now, row.first->id, row.first->ticker, row.second);
+        }
+    }
+    if (filter_) {
+        applyFilter(rows);
     }
     return rows;
 }
 
-int ScreenerEngine::handleList(bool realtime) {
-    if (!realtime) {
-        auto rows = collectRows();
-        if (rows.empty()) {
-            std::cout << "No tickers tracked. Add one with 'quantis screener add SYMBOL'.\n";
-            return 0;
+// Drops rows that fail --where, keeping order. Runs before rendering and
+// anomaly evaluation so neither sees filtered-out tickers. The columns were
+// filled by collectRows while each row was still hot in cache.
+void ScreenerEngine::applyFilter(ScreenerRows &rows) {
+    filter_->select(filter_columns_, filter_selection_);
+    std::size_t kept = 0;
+    for (std::uint32_t i : filter_selection_) {
+        if (i != kept) rows[kept] = std::move(rows[i]);
+        ++kept;
+    }
+    rows.resize(kept);
+}
+
+std::vector<AlertSet> ScreenerEngine::evaluateAlerts(const ScreenerRows &rows) {
+    std::vector<TickerId> ids;
+    std::vector<Quote> quotes;
+    ids.reserve(rows.size());
+    quotes.reserve(rows.size());
+    for (const auto &row : rows) {
+        ids.push_back(row.first->id);
+        quotes.push_back(row.second);
+    }
+
+    std::vector<AlertSet> alerts(rows.size());
+    auto start = std::chrono::steady_clock::now();
+    anomaly_->evaluate(ids, quotes, alerts);
+    metrics_.record(Stage::Evaluate, std::chrono::steady_clock::now() - start);
+    metrics_.recordAlerts(quotes, alerts,
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count());
+    return alerts;
+}
+
+// Call once the ticker list is loaded: the snapshot names tickers by symbol
+// and only ones the watchlist still tracks are restored.
+void ScreenerEngine::restoreAnomalies(std::ostream &out) {
+    auto start = std::chrono::steady_clock::now();
+    const auto &symbols = storage_.symbols();
+    auto restored = anomaly_snapshot::restore(
+        kAnomalySnapshotFile, *anomaly_, [&](std::string_view symbol) { return symbols.find(symbol); },
+        kAnomalySnapshotMaxAge);
+    if (!restored) return;
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    auto age = std::chrono::system_clock::now() -
+               std::chrono::system_clock::time_point(std::chrono::nanoseconds(restored->saved_at));
+    if (restored->expired) {
+        out << "Ignored anomaly history saved " << std::chrono::duration_cast<std::chrono::minutes>(age).count()
+            << " min ago; starting with empty windows\n";
+        return;
+    }
+    if (restored->tickers == 0) return;
+    out << "Restored anomaly history for " << restored->tickers << " tickers, saved "
+        << std::chrono::duration_cast<std::chrono::seconds>(age).count() << " s ago (" << std::fixed
+        << std::setprecision(1) << elapsed << " ms)\n"
+        << std::defaultfloat;
+}
+
+// Names come from the rows rather than the symbol table, which the fetch
+// stage may be growing on another thread. Only the copy of the windows
+// happens here; the file is written and synced on checkpoint_writer_, so a
+// slow disk does not hold up evaluation. A checkpoint that falls due while
+// the previous one is still being written is skipped.
+void ScreenerEngine::checkpointAnomalies(const ScreenerRows &rows) {
+    if (checkpoint_writing_.load(std::memory_order_acquire)) return;
+    awaitCheckpoint();
+    std::vector<std::string_view> names;
+    for (const auto &row : rows) {
+        TickerId id = row.first->id;
+        if (id >= names.size()) names.resize(id + 1);
+        names[id] = row.first->ticker;
+    }
+    anomaly_snapshot::capture(
+        *anomaly_, [&](TickerId id) { return id < names.size() ? names[id] : std::string_view(); },
+        checkpoint_image_);
+    checkpoint_writing_.store(true, std::memory_order_relaxed);
+    checkpoint_writer_ = std::thread([this] {
+        if (!anomaly_snapshot::write(kAnomalySnapshotFile, checkpoint_image_)) {
+            std::cerr << "Could not save anomaly history to " << kAnomalySnapshotFile << ": "
+                      << std::strerror(errno) << "\n";
         }
-        renderer_.render(rows);
+        checkpoint_writing_.store(false, std::memory_order_release);
+    });
+}
+
+void ScreenerEngine::awaitCheckpoint() {
+    if (checkpoint_writer_.joinable()) checkpoint_writer_.join();
+}
+
+int ScreenerEngine::handleList(bool realtime) {
+    if (realtime) {
+        return runRealtime(false, false);
+    }
+
+    auto rows = collectRows();
+    if (rows.empty()) {
+        std::cout << kNoTickersMessage;
+        return 0;
+    }
+    std::vector<AlertSet> alerts;
+    if (view_.sort == SortKey::Alerts) {
+        alerts = evaluateAlerts(rows);
+    }
+    RowRanking ranking(view_.sort);
+    std::cout << formatView(view_, ranking, rows, alerts, false, false);
+    return 0;
+}
+
+int ScreenerEngine::handleAlerts(bool realtime, bool alertsOnly) {
+    if (realtime) {
+        return runRealtime(true, alertsOnly);
+    }
+
+    auto rows = collectRows();
+    if (rows.empty()) {
+        std::cout << kNoTickersMessage;
         return 0;
     }
+    auto alerts = evaluateAlerts(rows);
+    RowRanking ranking(view_.sort);
+    std::cout << formatView(view_, ranking, rows, alerts, true, alertsOnly);
+    return 0;
+}
+
+// Formats the whole table, or with --sort/--top/--page only the requested
+// page of the ranking.
+std::string_view ScreenerEngine::formatView(const ViewSpec &view, RowRanking &ranking, const ScreenerRows &rows,
+                                            const std::vector<AlertSet> &alerts, bool withAlerts, bool alertsOnly) {
+    if (!view.paged()) {
+        return withAlerts ? renderer_.formatWithAlerts(rows, alerts, alertsOnly) : renderer_.format(rows);
+    }
+    std::size_t per_page = std::max<std::size_t>(view.top > 0 ? view.top : rows.size(), 1);
+    std::size_t pages_before = view.page - 1;
+    std::size_t begin = pages_before > rows.size() / per_page ? rows.size() : pages_before * per_page;
+    std::size_t end = begin + std::min(per_page, rows.size() - begin);
+    RowSelection selection{ranking.select(rows, alerts, begin, end), begin};
+    return withAlerts ? renderer_.formatWithAlerts(rows, alerts, alertsOnly, selection) : renderer_.format(rows, selection);
+}
+
+int ScreenerEngine::runRealtime(bool withAlerts, bool alertsOnly) {
+    std::unique_ptr<MetricsServer> metrics_server;
+    if (metrics_port_ != 0) {
+        try {
+            metrics_server = std::make_unique<MetricsServer>(metrics_port_);
+        } catch (const std::exception &ex) {
+            std::cerr << ex.what() << "\n";
+            return 1;
+        }
+    }
+
+    bool evaluating = withAlerts || view_.sort == SortKey::Alerts;
+    if (evaluating) {
+        storage_.listTickers();
+        restoreAnomalies(std::cout);
+    }
 
     std::atomic_bool running{true};
     g_running_flag = &running;
     std::signal(SIGINT, handleSignal);
 
+    SpscQueue<Frame> fetched(kStageQueueDepth);
+    SpscQueue<Frame> evaluated(kStageQueueDepth);
+    // Stages sleep on these rather than polling the queues: each is bumped
+    // when a frame is queued (ready) or taken (space). The fetcher's tick
+    // sleep is the only timed wait; once it sees 'running' drop it wakes the
+    // evaluator, which wakes the renderer, so each stage stops in turn.
+    std::atomic<std::uint32_t> fetched_ready{0};
+    std::atomic<std::uint32_t> fetched_space{0};
+    std::atomic<std::uint32_t> evaluated_ready{0};
+    auto wake = [](std::atomic<std::uint32_t> &signal) {
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+    };
+
+    // Fetch stage: ticks on absolute deadlines so the period does not stretch
+    // by the work time. Overrun ticks are skipped rather than replayed in a
+    // burst. Anomaly windows need every fetched tick, so this stage waits for
+    // the evaluator instead of dropping frames.
+    std::thread fetcher([&] {
+        auto next = std::chrono::steady_clock::now();
+        while (running.load()) {
+            Frame frame;
+            frame.rows = collectRows();
+            metrics_.count(FrameCounter::Fetched);
+            while (true) {
+                std::uint32_t seen = fetched_space.load(std::memory_order_acquire);
+                if (fetched.tryPush(std::move(frame))) {
+                    wake(fetched_ready);
+                    break;
+                }
+                if (!running.load()) break;
+                fetched_space.wait(seen, std::memory_order_acquire);
+            }
+
+            next += interval_;
+            auto now = std::chrono::steady_clock::now();
+            if (next < now) {
+                auto skipped = (now - next) / interval_ + 1;
+                next += interval_ * skipped;
+                metrics_.count(FrameCounter::Skipped, static_cast<std::uint64_t>(skipped));
+            }
+            std::this_thread::sleep_until(next);
+            metrics_.record(Stage::TickJitter, std::chrono::steady_clock::now() - next);
+        }
+        wake(fetched_ready);
+    });
+
+    // Evaluate stage: sleeps until the fetcher hands over a frame and never
+    // blocks on the renderer. If the render queue is full, the frame waits
+    // for the next tick and is replaced by it if the queue is still full.
+    // Anomaly windows are checkpointed from here, between evaluations.
+    bool evaluated_any = false;
+    std::thread evaluator([&] {
+        std::optional<Frame> pending;
+        Frame frame;
+        auto next_checkpoint = std::chrono::steady_clock::now() + kAnomalyCheckpointPeriod;
+        while (running.load()) {
+            std::uint32_t seen = fetched_ready.load(std::memory_order_acquire);
+            bool received = fetched.tryPop(frame);
+            if (received) {
+                wake(fetched_space);
+                if (evaluating) {
+                    frame.alerts = evaluateAlerts(frame.rows);
+                    evaluated_any = true;
+                    auto now = std::chrono::steady_clock::now();
+                    if (now >= next_checkpoint) {
+                        checkpointAnomalies(frame.rows);
+                        next_checkpoint = now + kAnomalyCheckpointPeriod;
+                    }
+                }
+                metrics_.count(FrameCounter::Evaluated);
+                if (pending) {
+                    metrics_.count(FrameCounter::Dropped);
+                }
+                pending = std::move(frame);
+            }
+            if (pending && evaluated.tryPush(std::move(*pending))) {
+                pending.reset();
+                wake(evaluated_ready);
+            }
+            if (!received) {
+                fetched_ready.wait(seen, std::memory_order_acquire);
+            }
+        }
+        wake(fetched_space);
+        wake(evaluated_ready);
+    });
+
+    // Render stage: drains everything queued and draws only the newest frame.
+    // Frames are formatted into the renderer's buffer and put on the terminal
+    // in one write. With --metrics-port, each drawn frame also publishes the
+    // metrics for the server thread to scrape; scrapes never touch this loop.
+    std::cout.flush();
+    TerminalPainter painter(repaint_, STDOUT_FILENO);
+    RowRanking ranking(view_.sort);
+    Frame frame;
     while (running.load()) {
-        std::cout << "\033[2J\033[H"; // clear screen and move cursor home
-        auto rows = collectRows();
-        if (rows.empty()) {
-            std::cout << "No tickers tracked. Add one with 'quantis screener add SYMBOL'.\n";
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::uint32_t seen = evaluated_ready.load(std::memory_order_acquire);
+        std::uint64_t received = 0;
+        while (evaluated.tryPop(frame)) {
+            ++received;
+        }
+        if (received == 0) {
+            evaluated_ready.wait(seen, std::memory_order_acquire);
             continue;
         }
-        renderer_.render(rows);
-        std::cout.flush();
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        metrics_.count(FrameCounter::Dropped, received - 1);
+
+        auto format_start = std::chrono::steady_clock::now();
+        std::string_view view = frame.rows.empty()
+                                    ? kNoTickersMessage
+                                    : formatView(view_, ranking, frame.rows, frame.alerts, withAlerts, alertsOnly);
+        auto write_start = std::chrono::steady_clock::now();
+        painter.paint(view);
+        metrics_.record(Stage::Format, write_start - format_start);
+        metrics_.record(Stage::Write, std::chrono::steady_clock::now() - write_start);
+        metrics_.count(FrameCounter::Drawn);
+
+        if (metrics_server) {
+            metrics_server->publish(MetricsSnapshot::from(*metrics_.snapshot(),
+                                                          tracked_tickers_.load(std::memory_order_relaxed),
+                                                          std::chrono::duration<double>(interval_).count()));
+        }
     }
 
+    fetcher.join();
+    evaluator.join();
     g_running_flag = nullptr;
+    // A session that never evaluated must not replace a good checkpoint.
+    if (evaluated_any && !frame.rows.empty()) {
+        awaitCheckpoint();
+        checkpointAnomalies(frame.rows);
+        awaitCheckpoint();
+    }
+
+    auto snapshot = metrics_.snapshot();
+    std::cout << "\n";
+    printSummary(std::cout, *snapshot);
+    if (!saveSnapshot(kStatsFile, *snapshot)) {
+        std::cerr << "Could not save session stats to " << kStatsFile << "\n";
+    }
     return 0;
 }
 
-int ScreenerEngine::handleAlerts(bool realtime, bool alertsOnly) {
-    if (!realtime) {
-        auto rows = collectRows();
-        if (rows.empty()) {
-            std::cout << "No tickers tracked. Add one with 'quantis screener add SYMBOL'.\n";
-            return 0;
-        }
-        std::vector<std::vector<std::string>> alerts;
-        alerts.reserve(rows.size());
-        for (const auto &row : rows) {
-            alerts.push_back(anomaly_->evaluate(row.first.ticker, row.second));
+int ScreenerEngine::handleStats() {
+    auto snapshot = std::make_unique<StageMetrics::Snapshot>();
+    if (!loadSnapshot(kStatsFile, *snapshot)) {
+        std::cout << "No realtime session stats yet. They are saved when 'list realtime' or 'alerts realtime' "
+                     "exits.\n";
+        return 1;
+    }
+    printSummary(std::cout, *snapshot);
+    return 0;
+}
+
+int ScreenerEngine::handleDaemon(std::vector<std::string> args) {
+    if (!applyOptions(args)) {
+        return 1;
+    }
+    if (filter_ || view_.paged()) {
+        std::cerr << "--where, --sort, --top and --page apply per query; pass them to the screener commands\n";
+        return 1;
+    }
+    if (!args.empty()) {
+        std::cerr << "Unexpected argument for daemon: " << args[0] << "\n";
+        return 1;
+    }
+    return runDaemon();
+}
+
+// Ticks like a realtime view without drawing, keeping the provider, ticker
+// cache and anomaly windows warm, and answers screener commands from the
+// latest tick in between.
+int ScreenerEngine::runDaemon() {
+    std::unique_ptr<DaemonServer> server;
+    std::unique_ptr<MetricsServer> metrics_server;
+    try {
+        server = std::make_unique<DaemonServer>(kDaemonSocket);
+        if (metrics_port_ != 0) {
+            metrics_server = std::make_unique<MetricsServer>(metrics_port_);
         }
-        renderer_.renderWithAlerts(rows, alerts, alertsOnly);
-        return 0;
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
     }
 
     std::atomic_bool running{true};
     g_running_flag = &running;
     std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
 
-    while (running.load()) {
-        std::cout << "\033[2J\033[H"; // clear screen and move cursor home
-        auto rows = collectRows();
-        if (rows.empty()) {
-            std::cout << "No tickers tracked. Add one with 'quantis screener add SYMBOL'.\n";
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            continue;
+    storage_.listTickers();
+    restoreAnomalies(std::cout);
+
+    ScreenerRows rows;
+    std::vector<AlertSet> alerts;
+    auto next_checkpoint = std::chrono::steady_clock::now() + kAnomalyCheckpointPeriod;
+    auto tick = [&] {
+        rows = collectRows();
+        alerts = evaluateAlerts(rows);
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_checkpoint) {
+            checkpointAnomalies(rows);
+            next_checkpoint = now + kAnomalyCheckpointPeriod;
         }
-        std::vector<std::vector<std::string>> alerts;
-        alerts.reserve(rows.size());
-        for (const auto &row : rows) {
-            alerts.push_back(anomaly_->evaluate(row.first.ticker, row.second));
+        metrics_.count(FrameCounter::Fetched);
+        metrics_.count(FrameCounter::Evaluated);
+        if (metrics_server) {
+            metrics_server->publish(MetricsSnapshot::from(*metrics_.snapshot(),
+                                                          tracked_tickers_.load(std::memory_order_relaxed),
+                                                          std::chrono::duration<double>(interval_).count()));
         }
-        renderer_.renderWithAlerts(rows, alerts, alertsOnly);
-        std::cout.flush();
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
+    };
+    // Changes to the watchlist tick straight away so the next query sees them.
+    auto answer = [&](const daemon_protocol::Request &request, daemon_protocol::Reply &reply) {
+        answerRequest(request, rows, alerts, reply);
+        bool changed = request.command == daemon_protocol::Command::Add ||
+                       request.command == daemon_protocol::Command::Remove;
+        if (changed && reply.status == 0) tick();
+    };
 
+    std::cout << "quantis daemon listening on " << kDaemonSocket << ", ticking every " << interval_.count()
+              << " ms\n"
+              << std::flush;
+    int status = 0;
+    try {
+        tick();
+        auto next = std::chrono::steady_clock::now() + interval_;
+        while (running.load()) {
+            server->serveUntil(next, answer);
+            auto now = std::chrono::steady_clock::now();
+            if (!running.load() || now < next) continue;
+            metrics_.record(Stage::TickJitter, now - next);
+            tick();
+            next += interval_;
+            now = std::chrono::steady_clock::now();
+            if (next < now) {
+                auto skipped = (now - next) / interval_ + 1;
+                next += interval_ * skipped;
+                metrics_.count(FrameCounter::Skipped, static_cast<std::uint64_t>(skipped));
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        status = 1;
+    }
     g_running_flag = nullptr;
+    if (!rows.empty()) {
+        awaitCheckpoint();
+        checkpointAnomalies(rows);
+        awaitCheckpoint();
+    }
+    std::cout << "quantis daemon stopped\n";
+    return status;
+}
+
+void ScreenerEngine::answerRequest(const daemon_protocol::Request &request, const ScreenerRows &rows,
+                                   const std::vector<AlertSet> &alerts, daemon_protocol::Reply &reply) {
+    using daemon_protocol::Command;
+    // Replies are written straight into `reply`; std::cout and std::cerr stay
+    // with the daemon, whose feed thread may be writing to them.
+    std::ostringstream out;
+    std::ostringstream err;
+    auto answered = [&](int status) {
+        reply.status = status;
+        reply.out = out.str();
+        reply.err = err.str();
+    };
+    switch (request.command) {
+    case Command::ClearAlerts:
+        answered(handleAlertsClear(out, err));
+        return;
+    case Command::Add:
+        answered(handleAdd(request.symbol, out, err));
+        return;
+    case Command::Remove:
+        answered(handleRemove(request.symbol, out, err));
+        return;
+    case Command::Export:
+    case Command::List:
+    case Command::Alerts:
+    case Command::AlertsOnly:
+        break;
+    }
+
+    // Filtering and ranking are per query; the daemon's own tick always
+    // covers every tracked ticker.
+    const ScreenerRows *view_rows = &rows;
+    const std::vector<AlertSet> *view_alerts = &alerts;
+    ScreenerRows filtered_rows;
+    filtered_rows.tickers = rows.tickers;
+    std::vector<AlertSet> filtered_alerts;
+    if (!request.where.empty()) {
+        try {
+            FilterExpression filter = FilterExpression::compile(request.where);
+            filter_columns_.load(rows, &storage_.symbols());
+            filter.select(filter_columns_, filter_selection_);
+        } catch (const std::exception &ex) {
+            reply.err = std::string(ex.what()) + "\n";
+            reply.status = 1;
+            return;
+        }
+        for (std::uint32_t i : filter_selection_) {
+            filtered_rows.push_back(rows[i]);
+            filtered_alerts.push_back(alerts[i]);
+        }
+        view_rows = &filtered_rows;
+        view_alerts = &filtered_alerts;
+    }
+    if (request.command == Command::Export) {
+        storage_.exportToCsv(reply.out, *view_rows, pool_.get());
+        return;
+    }
+    if (view_rows->empty()) {
+        reply.out = kNoTickersMessage;
+        return;
+    }
+    ViewSpec view{request.sort, request.top, std::max<std::size_t>(request.page, 1)};
+    RowRanking ranking(view.sort);
+    bool with_alerts = request.command != Command::List;
+    reply.out += formatView(view, ranking, *view_rows, *view_alerts, with_alerts, request.command == Command::AlertsOnly);
+}
+
+// Answers `quantis screener ...` through a running daemon when it can. Returns
+// std::nullopt to run the command locally: when it is not one the daemon
+// serves, when it configures the engine, or when no daemon is listening.
+std::optional<int> ScreenerEngine::forwardToDaemon(int argc, char **argv) {
+    if (argc < 3 || std::string(argv[1]) != "screener") return std::nullopt;
+    std::vector<std::string> args = sliceArgs(argc, argv, 2);
+    for (const char *flag : kEngineOptions) {
+        if (std::find(args.begin(), args.end(), flag) != args.end()) return std::nullopt;
+    }
+
+    using daemon_protocol::Command;
+    daemon_protocol::Request request;
+    std::optional<std::string> out;
+    // Bad options are reported by the local run, as they always were.
+    try {
+        if (auto where = takeOption(args, "--where")) request.where = *where;
+        if (auto sort = takeOption(args, "--sort")) request.sort = parseSortKey(*sort);
+        if (auto top = takeOption(args, "--top")) request.top = static_cast<std::uint32_t>(parseCount(*top, "--top"));
+        if (auto page = takeOption(args, "--page")) {
+            request.page = static_cast<std::uint32_t>(parseCount(*page, "--page"));
+            if (request.top == 0) return std::nullopt;
+        }
+        out = takeOption(args, "--out");
+    } catch (const std::exception &) {
+        return std::nullopt;
+    }
+    if (args.empty()) return std::nullopt;
+
+    const std::string &sub = args[0];
+    if (sub == "list" && args.size() == 1) {
+        request.command = Command::List;
+    } else if (sub == "alerts" && args.size() == 1) {
+        request.command = Command::Alerts;
+    } else if (sub == "alerts" && args.size() == 2 && (args[1] == "list" || args[1] == "clear")) {
+        request.command = args[1] == "list" ? Command::AlertsOnly : Command::ClearAlerts;
+    } else if ((sub == "add" || sub == "remove") && args.size() == 2 && args[1] != "--from") {
+        request.command = sub == "add" ? Command::Add : Command::Remove;
+        request.symbol = args[1];
+    } else if (sub == "export" && args.size() == 2 && args[1] == "csv") {
+        request.command = Command::Export;
+    } else {
+        return std::nullopt;
+    }
+    if (out && request.command != Command::Export) return std::nullopt;
+
+    auto reply = callDaemon(kDaemonSocket, request);
+    if (!reply) return std::nullopt;
+    std::cerr << reply->err;
+    if (request.command != Command::Export || reply->status != 0) {
+        std::cout << reply->out;
+        return reply->status;
+    }
+
+    // The daemon sends the CSV back; files are written with this process's
+    // working directory and permissions.
+    std::string filename = out.value_or("quantis_export.csv");
+    if (filename == "-") {
+        std::cout << reply->out;
+        return std::cout.flush() ? 0 : 1;
+    }
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file for writing: " << filename << "\n";
+        return 1;
+    }
+    if (!file.write(reply->out.data(), static_cast<std::streamsize>(reply->out.size())).flush()) {
+        std::cerr << "Failed writing " << filename << "\n";
+        return 1;
+    }
+    std::cout << "Exported to " << filename << "\n";
     return 0;
 }
 
-int ScreenerEngine::handleAlertsClear() {
+int ScreenerEngine::handleAlertsClear(std::ostream &out, std::ostream &err) {
     anomaly_->clear();
-    std::cout << "Cleared anomaly history.\n";
+    awaitCheckpoint();
+    if (::unlink(kAnomalySnapshotFile) != 0 && errno != ENOENT) {
+        err << "Could not remove " << kAnomalySnapshotFile << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    out << "Cleared anomaly history.\n";
     return 0;
 }
 
-int ScreenerEngine::handleAdd(const std::string &ticker) {
-    if (storage_.addTicker(ticker)) {
-        std::cout << "Added ticker " << ticker << "\n";
+int ScreenerEngine::handleAdd(const std::string &ticker, std::ostream &out, std::ostream &err) {
+    if (storage_.addTicker(ticker, "", "", "", "", err)) {
+        out << "Added ticker " << ticker << "\n";
         return 0;
     }
     return 1;
 }
 
-int ScreenerEngine::handleRemove(const std::string &ticker) {
-    if (storage_.removeTicker(ticker)) {
-        std::cout << "Removed ticker " << ticker << "\n";
+int ScreenerEngine::handleRemove(const std::string &ticker, std::ostream &out, std::ostream &err) {
+    if (storage_.removeTicker(ticker, err)) {
+        out << "Removed ticker " << ticker << "\n";
         return 0;
     }
     return 1;
 }
 
-int ScreenerEngine::handleExport() {
+int ScreenerEngine::handleImport(const std::string &path) {
+    std::ifstream file;
+    std::istream *in = openInput(path, file);
+    if (!in) return 1;
+
+    SymbolFileReader reader(*in);
+    std::vector<std::string> fields;
+    auto next = [&](TickerRecord &record) {
+        if (!reader.next(fields)) return false;
+        fields.resize(std::max<std::size_t>(fields.size(), 5));
+        record.ticker = std::move(fields[0]);
+        record.name = std::move(fields[1]);
+        record.sector = std::move(fields[2]);
+        record.industry = std::move(fields[3]);
+        record.notes = std::move(fields[4]);
+        return true;
+    };
+
+    Storage::BulkResult result;
+    if (!storage_.importTickers(next, result)) {
+        std::cerr << "Import failed; no tickers were added.\n";
+        return 1;
+    }
+    std::cout << "Imported " << result.applied << " tickers (" << result.unchanged << " already tracked)\n";
+    return 0;
+}
+
+int ScreenerEngine::handleBulkRemove(const std::string &path) {
+    std::ifstream file;
+    std::istream *in = openInput(path, file);
+    if (!in) return 1;
+
+    SymbolFileReader reader(*in);
+    std::vector<std::string> fields;
+    auto next = [&](std::string &ticker) {
+        if (!reader.next(fields)) return false;
+        ticker = std::move(fields[0]);
+        return true;
+    };
+
+    Storage::BulkResult result;
+    if (!storage_.removeTickers(next, result)) {
+        std::cerr << "Removal failed; no tickers were removed.\n";
+        return 1;
+    }
+    std::cout << "Removed " << result.applied << " tickers (" << result.unchanged << " not tracked)\n";
+    return 0;
+}
+
+int ScreenerEngine::handleReplay(const std::string &path, double speed) {
+    using Clock = std::chrono::steady_clock;
+
+    std::unique_ptr<ReplayReader> reader;
+    try {
+        reader = std::make_unique<ReplayReader>(
+            path, std::chrono::duration_cast<std::chrono::nanoseconds>(interval_).count());
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+
+    std::atomic_bool running{true};
+    g_running_flag = &running;
+    std::signal(SIGINT, handleSignal);
+
+    ShardedAnomalyEngine engine(pool_->size());
+    ReplayTick tick;
+    std::vector<AlertSet> alerts;
+    std::array<std::uint64_t, kAlertCount> per_rule{};
+    std::uint64_t ticks = 0;
+    std::uint64_t quotes = 0;
+    Clock::duration decode_time{};
+    Clock::duration evaluate_time{};
+    Clock::duration pacing_time{};
+    std::int64_t first_timestamp = 0;
+    auto start = Clock::now();
+    auto replay_start = start;
+
+    try {
+        while (running.load()) {
+            auto decode_start = Clock::now();
+            if (!reader->next(tick)) break;
+            auto decode_end = Clock::now();
+            decode_time += decode_end - decode_start;
+
+            if (ticks == 0) {
+                first_timestamp = tick.timestamp_ns;
+                replay_start = decode_end;
+            }
+            if (speed > 0.0) {
+                auto offset = static_cast<double>(tick.timestamp_ns - first_timestamp) / speed;
+                std::this_thread::sleep_until(replay_start + std::chrono::nanoseconds(static_cast<std::int64_t>(offset)));
+            }
+
+            auto evaluate_start = Clock::now();
+            pacing_time += evaluate_start - decode_end;
+            alerts.resize(tick.quotes.size());
+            engine.evaluate(tick.ids, tick.quotes, alerts);
+            evaluate_time += Clock::now() - evaluate_start;
+
+            for (AlertSet set : alerts) {
+                for (std::size_t rule = 0; rule < kAlertCount; ++rule) {
+                    per_rule[rule] += (set >> rule) & 1u;
+                }
+            }
+            ++ticks;
+            quotes += tick.quotes.size();
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        g_running_flag = nullptr;
+        return 1;
+    }
+    g_running_flag = nullptr;
+
+    auto seconds = [](Clock::duration d) { return std::chrono::duration<double>(d).count(); };
+    double elapsed = seconds(Clock::now() - start);
+    double per_tick_ms = ticks ? 1e3 / static_cast<double>(ticks) : 0.0;
+
+    std::cout << std::fixed << std::setprecision(3) << "Replayed " << ticks << " ticks (" << quotes << " quotes) from "
+              << path << " in " << elapsed << " s\n"
+              << std::setprecision(1) << "  Throughput: " << (elapsed > 0 ? ticks / elapsed : 0.0) << " ticks/s, "
+              << (elapsed > 0 ? quotes / elapsed : 0.0) << " quotes/s\n"
+              << std::setprecision(3) << "  Stage timing (total s / per tick ms):\n"
+              << "    decode    " << std::setw(10) << seconds(decode_time) << std::setw(12)
+              << seconds(decode_time) * per_tick_ms << "\n"
+              << "    evaluate  " << std::setw(10) << seconds(evaluate_time) << std::setw(12)
+              << seconds(evaluate_time) * per_tick_ms << "\n"
+              << "    pacing    " << std::setw(10) << seconds(pacing_time) << std::setw(12)
+              << seconds(pacing_time) * per_tick_ms << "\n"
+              << "  Alerts per rule:\n";
+    for (std::size_t rule = 0; rule < kAlertCount; ++rule) {
+        std::cout << "    " << std::left << std::setw(18) << kAlertTable[rule].name << std::right << per_rule[rule] << "\n";
+    }
+    return 0;
+}
+
+int ScreenerEngine::handleExport(const std::string &filename) {
     auto rows = collectRows();
-    const std::string filename = "quantis_export.csv";
-    if (storage_.exportToCsv(filename, rows)) {
+    if (!storage_.exportToCsv(filename, rows, pool_.get())) {
+        return 1;
+    }
+    if (filename != "-") {
         std::cout << "Exported to " << filename << "\n";
-        return 0;
     }
-    return 1;
+    return 0;
 }
 
@@ -1,10 +1,113 @@
 #include "Storage.hpp"
+#include "Csv.hpp"
+#include "WorkerPool.hpp"
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
-#include <fstream>
+#include <cstring>
+#include <fcntl.h>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <unistd.h>
+
+namespace {
+constexpr std::size_t kExportChunkRows = 8192;
+constexpr std::size_t kParallelExportRows = 65536;
+
+bool writeAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+std::string currentTimestamp() {
+    auto now = std::chrono::system_clock::now();
+    std::time_t t = std::chrono::system_clock::to_time_t(now);
+    std::tm tm = *std::localtime(&t);
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return oss.str();
+}
+
+// Resets a reused prepared statement when the current use goes out of scope.
+class StatementReset {
+public:
+    explicit StatementReset(sqlite3_stmt *stmt) : stmt_(stmt) {}
+    ~StatementReset() {
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+    }
+
+    StatementReset(const StatementReset &) = delete;
+    StatementReset &operator=(const StatementReset &) = delete;
+
+private:
+    sqlite3_stmt *stmt_;
+};
+
+// Formats rows as CSV and hands the text to `sink` in row order, in chunks;
+// stops early if the sink fails.
+bool formatCsv(const ScreenerRows &rows, WorkerPool *pool, const std::function<bool(std::string_view)> &sink) {
+    // Rows are formatted in batches of kExportChunkRows per worker into
+    // per-worker buffers, which are then written in worker order so the file
+    // keeps the row order. Buffers are reused across batches.
+    std::size_t workers = pool && rows.size() >= kParallelExportRows ? pool->size() : 1;
+    std::vector<std::string> buffers(workers);
+    for (auto &buffer : buffers) {
+        buffer.reserve(kExportChunkRows * 256);
+    }
+    buffers[0] = "ticker,name,sector,industry,notes,date_added,price,market_cap,daily_percent_change,volume,average_volume,52w_high,52w_low,bid,ask\n";
+
+    auto format = [&](std::size_t base, std::size_t worker, std::size_t begin, std::size_t end) {
+        CsvFormatter csv(buffers[worker]);
+        for (std::size_t i = base + begin; i < base + end; ++i) {
+            const auto &meta = *rows[i].first;
+            const auto &quote = rows[i].second;
+            csv.field(meta.ticker);
+            csv.field(meta.name);
+            csv.field(meta.sector);
+            csv.field(meta.industry);
+            csv.field(meta.notes);
+            csv.field(meta.date_added);
+            csv.field(quote.price);
+            csv.field(quote.market_cap);
+            csv.field(quote.daily_percent_change);
+            csv.field(quote.volume);
+            csv.field(quote.average_volume);
+            csv.field(quote.fiftytwo_week_high);
+            csv.field(quote.fiftytwo_week_low);
+            csv.field(quote.bid);
+            csv.field(quote.ask);
+            csv.endRow();
+        }
+    };
+
+    std::size_t batch = workers * kExportChunkRows;
+    for (std::size_t base = 0; base < rows.size() || base == 0; base += batch) {
+        std::size_t count = std::min(batch, rows.size() - base);
+        if (workers > 1) {
+            pool->parallelFor(count, [&](std::size_t worker, std::size_t begin, std::size_t end) {
+                format(base, worker, begin, end);
+            });
+        } else {
+            format(base, 0, 0, count);
+        }
+        for (auto &buffer : buffers) {
+            if (!sink(buffer)) return false;
+            buffer.clear();
+        }
+    }
+    return true;
+}
+}
 
 Storage::Storage(const std::string &db_path) : db_path_(db_path) {
     if (sqlite3_open(db_path_.c_str(), &db_) != SQLITE_OK) {
@@ -14,6 +117,9 @@ Storage::Storage(const std::string &db_path) : db_path_(db_path) {
 }
 
 Storage::~Storage() {
+    for (auto *stmt : {insert_stmt_, delete_stmt_, select_stmt_, version_stmt_}) {
+        sqlite3_finalize(stmt);
+    }
     if (db_) {
         sqlite3_close(db_);
     }
@@ -29,6 +135,8 @@ void Storage::initialize() {
             notes TEXT,
             date_added TEXT
         );
+        PRAGMA journal_mode = WAL;
+        PRAGMA synchronous = NORMAL;
     )SQL";
 
     char *errmsg = nullptr;
@@ -37,87 +145,157 @@ void Storage::initialize() {
         sqlite3_free(errmsg);
         throw std::runtime_error("Failed to initialize database: " + message);
     }
+    prepareStatements();
 }
 
-bool Storage::tickerExists(const std::string &ticker) {
-    const char *sql = "SELECT COUNT(*) FROM tickers WHERE ticker = ?";
+void Storage::prepareStatements() {
+    insert_stmt_ = prepare("INSERT INTO tickers (ticker, name, sector, industry, notes, date_added) "
+                           "VALUES (?, ?, ?, ?, ?, ?) ON CONFLICT (ticker) DO NOTHING");
+    delete_stmt_ = prepare("DELETE FROM tickers WHERE ticker = ?");
+    select_stmt_ = prepare("SELECT ticker, name, sector, industry, notes, date_added FROM tickers ORDER BY ticker");
+    version_stmt_ = prepare("PRAGMA data_version");
+}
+
+sqlite3_stmt *Storage::prepare(const char *sql) {
     sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        return false;
+    if (sqlite3_prepare_v3(db_, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db_)));
     }
+    return stmt;
+}
 
-    sqlite3_bind_text(stmt, 1, ticker.c_str(), -1, SQLITE_TRANSIENT);
-    bool exists = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        int count = sqlite3_column_int(stmt, 0);
-        exists = count > 0;
+bool Storage::execute(const char *sql) {
+    char *errmsg = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &errmsg) != SQLITE_OK) {
+        std::cerr << "Failed to execute '" << sql << "': " << (errmsg ? errmsg : "unknown error") << "\n";
+        sqlite3_free(errmsg);
+        return false;
     }
-    sqlite3_finalize(stmt);
-    return exists;
+    return true;
 }
 
-bool Storage::addTicker(const std::string &ticker, const std::string &name, const std::string &sector,
-                        const std::string &industry, const std::string &notes) {
-    if (tickerExists(ticker)) {
-        std::cerr << "Ticker already exists: " << ticker << "\n";
-        return false;
+// A COMMIT that fails (e.g. SQLITE_BUSY) leaves the transaction open, and
+// every later statement on this connection would run inside it.
+bool Storage::commit() {
+    if (execute("COMMIT")) return true;
+    if (!sqlite3_get_autocommit(db_)) {
+        execute("ROLLBACK");
     }
+    return false;
+}
 
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::localtime(&t);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+Storage::WriteResult Storage::insertTicker(const TickerRecord &record, std::ostream &err) {
+    sqlite3_stmt *stmt = insert_stmt_;
+    StatementReset reset(stmt);
 
-    const char *sql = "INSERT INTO tickers (ticker, name, sector, industry, notes, date_added) VALUES (?, ?, ?, ?, ?, ?)";
-    sqlite3_stmt *stmt = nullptr;
+    sqlite3_bind_text(stmt, 1, record.ticker.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, record.name.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, record.sector.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, record.industry.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 5, record.notes.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 6, record.date_added.c_str(), -1, SQLITE_STATIC);
 
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare insert statement: " << sqlite3_errmsg(db_) << "\n";
-        return false;
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        err << "Failed to add ticker: " << sqlite3_errmsg(db_) << "\n";
+        return WriteResult::Failed;
     }
+    snapshot_stale_ = true;
+    return sqlite3_changes(db_) > 0 ? WriteResult::Applied : WriteResult::Unchanged;
+}
 
-    sqlite3_bind_text(stmt, 1, ticker.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, sector.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 4, industry.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 5, notes.c_str(), -1, SQLITE_TRANSIENT);
-    auto timestamp = oss.str();
-    sqlite3_bind_text(stmt, 6, timestamp.c_str(), -1, SQLITE_TRANSIENT);
+Storage::WriteResult Storage::deleteTicker(const std::string &ticker, std::ostream &err) {
+    sqlite3_stmt *stmt = delete_stmt_;
+    StatementReset reset(stmt);
 
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    if (!success) {
-        std::cerr << "Failed to add ticker: " << sqlite3_errmsg(db_) << "\n";
+    sqlite3_bind_text(stmt, 1, ticker.c_str(), -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        err << "Failed to remove ticker: " << sqlite3_errmsg(db_) << "\n";
+        return WriteResult::Failed;
     }
-    sqlite3_finalize(stmt);
-    return success;
+    snapshot_stale_ = true;
+    return sqlite3_changes(db_) > 0 ? WriteResult::Applied : WriteResult::Unchanged;
 }
 
-bool Storage::removeTicker(const std::string &ticker) {
-    const char *sql = "DELETE FROM tickers WHERE ticker = ?";
-    sqlite3_stmt *stmt = nullptr;
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare delete statement: " << sqlite3_errmsg(db_) << "\n";
-        return false;
+bool Storage::addTicker(const std::string &ticker, const std::string &name, const std::string &sector,
+                        const std::string &industry, const std::string &notes, std::ostream &err) {
+    TickerRecord record;
+    record.ticker = ticker;
+    record.name = name;
+    record.sector = sector;
+    record.industry = industry;
+    record.notes = notes;
+    record.date_added = currentTimestamp();
+
+    auto result = insertTicker(record, err);
+    if (result == WriteResult::Unchanged) {
+        err << "Ticker already exists: " << ticker << "\n";
     }
-    sqlite3_bind_text(stmt, 1, ticker.c_str(), -1, SQLITE_TRANSIENT);
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    if (!success) {
-        std::cerr << "Failed to remove ticker: " << sqlite3_errmsg(db_) << "\n";
+    return result == WriteResult::Applied;
+}
+
+bool Storage::removeTicker(const std::string &ticker, std::ostream &err) {
+    return deleteTicker(ticker, err) != WriteResult::Failed;
+}
+
+bool Storage::importTickers(const std::function<bool(TickerRecord &)> &next, BulkResult &result) {
+    if (!execute("BEGIN IMMEDIATE")) return false;
+
+    const std::string timestamp = currentTimestamp();
+    TickerRecord record;
+    while (next(record)) {
+        record.date_added = timestamp;
+        auto outcome = insertTicker(record, std::cerr);
+        if (outcome == WriteResult::Failed) {
+            execute("ROLLBACK");
+            return false;
+        }
+        ++(outcome == WriteResult::Applied ? result.applied : result.unchanged);
     }
-    sqlite3_finalize(stmt);
-    return success;
+    return commit();
 }
 
-std::vector<TickerRecord> Storage::listTickers() {
-    const char *sql = "SELECT ticker, name, sector, industry, notes, date_added FROM tickers ORDER BY ticker";
-    sqlite3_stmt *stmt = nullptr;
-    std::vector<TickerRecord> records;
+bool Storage::removeTickers(const std::function<bool(std::string &)> &next, BulkResult &result) {
+    if (!execute("BEGIN IMMEDIATE")) return false;
 
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare select statement: " << sqlite3_errmsg(db_) << "\n";
-        return records;
+    std::string ticker;
+    while (next(ticker)) {
+        auto outcome = deleteTicker(ticker, std::cerr);
+        if (outcome == WriteResult::Failed) {
+            execute("ROLLBACK");
+            return false;
+        }
+        ++(outcome == WriteResult::Applied ? result.applied : result.unchanged);
     }
+    return commit();
+}
+
+TickerSnapshot Storage::listTickers() {
+    // data_version only moves for commits made by other connections; writes
+    // through this one mark the snapshot stale directly.
+    long long version = dataVersion();
+    if (snapshot_stale_ || version != snapshot_version_) {
+        reloadSnapshot();
+        snapshot_version_ = version;
+        snapshot_stale_ = false;
+    }
+    return snapshot_;
+}
+
+long long Storage::dataVersion() {
+    StatementReset reset(version_stmt_);
+    if (sqlite3_step(version_stmt_) != SQLITE_ROW) {
+        return -1;
+    }
+    return sqlite3_column_int64(version_stmt_, 0);
+}
+
+void Storage::reloadSnapshot() {
+    sqlite3_stmt *stmt = select_stmt_;
+    StatementReset reset(stmt);
+    // A new generation rather than an update in place: rows of earlier ticks
+    // may still point into the old one.
+    std::vector<TickerRecord> tickers;
+    tickers.reserve(snapshot_ ? snapshot_->size() : 0);
 
     auto readText = [](sqlite3_stmt *statement, int col) {
         const unsigned char *text = sqlite3_column_text(statement, col);
@@ -127,48 +305,41 @@ std::vector<TickerRecord> Storage::listTickers() {
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         TickerRecord rec;
         rec.ticker = readText(stmt, 0);
+        rec.id = symbols_.intern(rec.ticker);
         rec.name = readText(stmt, 1);
         rec.sector = readText(stmt, 2);
         rec.industry = readText(stmt, 3);
         rec.notes = readText(stmt, 4);
         rec.date_added = readText(stmt, 5);
-        records.push_back(std::move(rec));
+        tickers.push_back(std::move(rec));
     }
-    sqlite3_finalize(stmt);
-    return records;
+    snapshot_ = std::make_shared<const std::vector<TickerRecord>>(std::move(tickers));
 }
 
-bool Storage::exportToCsv(const std::string &filename, const ScreenerRows &rows) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
+SymbolTable &Storage::symbols() { return symbols_; }
+
+
+bool Storage::exportToCsv(const std::string &filename, const ScreenerRows &rows, WorkerPool *pool) {
+    bool to_stdout = filename == "-";
+    int fd = to_stdout ? STDOUT_FILENO : ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
         std::cerr << "Unable to open file for writing: " << filename << "\n";
         return false;
     }
 
-    file << "ticker,name,sector,industry,notes,date_added,price,market_cap,daily_percent_change,volume,average_volume,52w_high,52w_low,bid,ask\n";
-    for (const auto &row : rows) {
-        const auto &meta = row.first;
-        const auto &quote = row.second;
-        auto writeField = [&file](const auto &value) {
-            file << '"' << value << '"';
-        };
-
-        writeField(meta.ticker); file << ',';
-        writeField(meta.name); file << ',';
-        writeField(meta.sector); file << ',';
-        writeField(meta.industry); file << ',';
-        writeField(meta.notes); file << ',';
-        writeField(meta.date_added); file << ',';
-        writeField(quote.price); file << ',';
-        writeField(quote.market_cap); file << ',';
-        writeField(quote.daily_percent_change); file << ',';
-        writeField(quote.volume); file << ',';
-        writeField(quote.average_volume); file << ',';
-        writeField(quote.fiftytwo_week_high); file << ',';
-        writeField(quote.fiftytwo_week_low); file << ',';
-        writeField(quote.bid); file << ',';
-        writeField(quote.ask);
-        file << "\n";
+    bool ok = formatCsv(rows, pool, [fd](std::string_view chunk) { return writeAll(fd, chunk); });
+    if (!to_stdout && ::close(fd) != 0) {
+        ok = false;
     }
-    return true;
+    if (!ok) {
+        std::cerr << "Failed writing " << filename << ": " << std::strerror(errno) << "\n";
+    }
+    return ok;
+}
+
+void Storage::exportToCsv(std::string &out, const ScreenerRows &rows, WorkerPool *pool) {
+    formatCsv(rows, pool, [&out](std::string_view chunk) {
+        out += chunk;
+        return true;
+    });
 }
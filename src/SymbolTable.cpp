@@ -0,0 +1,41 @@
+#include "SymbolTable.hpp"
+#include <mutex>
+#include <stdexcept>
+
+TickerId SymbolTable::intern(std::string_view symbol) {
+    auto it = ids_.find(symbol);
+    if (it != ids_.end()) return it->second;
+
+    auto id = static_cast<TickerId>(symbols_.size());
+    symbols_.emplace_back(symbol);
+    ids_.emplace(symbols_.back(), id);
+    return id;
+}
+
+TickerId SymbolTable::find(std::string_view symbol) const {
+    auto it = ids_.find(symbol);
+    return it == ids_.end() ? kInvalidId : it->second;
+}
+
+const std::string &SymbolTable::symbol(TickerId id) const {
+    if (id >= symbols_.size()) {
+        throw std::out_of_range("Unknown ticker id: " + std::to_string(id));
+    }
+    return symbols_[id];
+}
+
+std::size_t SymbolTable::size() const { return symbols_.size(); }
+
+std::string_view SymbolTable::displayName(TickerId id, std::string_view fallback) const {
+    std::shared_lock lock(names_mutex_);
+    if (id >= name_slots_.size() || name_slots_[id] == 0) return fallback;
+    return names_[name_slots_[id] - 1];
+}
+
+void SymbolTable::setName(TickerId id, std::string_view name) {
+    std::unique_lock lock(names_mutex_);
+    if (id >= name_slots_.size()) name_slots_.resize(static_cast<std::size_t>(id) + 1, 0);
+    if (name_slots_[id] != 0) return;
+    names_.emplace_back(name);
+    name_slots_[id] = static_cast<std::uint32_t>(names_.size());
+}
@@ -0,0 +1,94 @@
+#include "SyntheticMarketData.hpp"
+#include <chrono>
+#include <random>
+
+namespace {
+std::int64_t unixNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+}
+
+SyntheticMarketData::SyntheticMarketData(SymbolTable &symbols)
+    : SyntheticMarketData(symbols, static_cast<unsigned long>(
+                                       std::chrono::high_resolution_clock::now().time_since_epoch().count())) {}
+
+SyntheticMarketData::SyntheticMarketData(SymbolTable &symbols, unsigned long seed) : symbols_(symbols), rng_(seed) {}
+
+Quote SyntheticMarketData::getQuote(const std::string &ticker) {
+    TickerId id = symbols_.find(ticker);
+    if (simulator_ && id != SymbolTable::kInvalidId) {
+        Quote q;
+        getQuotes(std::span<const TickerId>(&id, 1), std::span<Quote>(&q, 1));
+        return q;
+    }
+    return nextQuote();
+}
+
+void SyntheticMarketData::getQuotes(std::span<const TickerId> ids, std::span<Quote> quotes) {
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        TickerId id = ids[i];
+        if (id >= named_.size()) named_.resize(static_cast<std::size_t>(id) + 1, false);
+        if (!named_[id]) {
+            symbols_.setName(id, symbols_.symbol(id) + " Corp");
+            named_[id] = true;
+        }
+    }
+    if (simulator_) {
+        simulator_->step(ids, quotes);
+    } else {
+        for (auto &q : quotes.first(ids.size())) {
+            q = nextQuote();
+        }
+    }
+    std::int64_t now = unixNanos();
+    for (auto &q : quotes.first(ids.size())) {
+        q.timestamp_ns = now;
+    }
+}
+
+void SyntheticMarketData::beginTick(std::span<const TickerId>) {
+    if (simulator_) {
+        simulator_->advance(symbols_.size());
+    }
+}
+
+std::unique_ptr<MarketDataProvider> SyntheticMarketData::forWorker(unsigned long seed) {
+    auto worker = std::make_unique<SyntheticMarketData>(symbols_, seed);
+    worker->setSimulator(simulator_);
+    return worker;
+}
+
+void SyntheticMarketData::setSimulator(MarketSimulator *simulator) { simulator_ = simulator; }
+
+Quote SyntheticMarketData::nextQuote() {
+    std::uniform_real_distribution<double> price_dist(10.0, 500.0);
+    std::uniform_real_distribution<double> pct_dist(-5.0, 5.0);
+    std::uniform_real_distribution<double> spread_dist(0.01, 1.0);
+    std::uniform_real_distribution<double> cap_dist(1e9, 5e12);
+    std::uniform_int_distribution<long long> vol_dist(100000, 50000000);
+    std::uniform_real_distribution<double> fiftytwo_dist(5.0, 550.0);
+
+    double price = price_dist(rng_);
+    double change = pct_dist(rng_);
+
+    Quote q;
+    q.price = price;
+    q.market_cap = cap_dist(rng_);
+    q.daily_percent_change = change;
+    q.volume = vol_dist(rng_);
+    q.average_volume = vol_dist(rng_);
+    double high = fiftytwo_dist(rng_);
+    double low = fiftytwo_dist(rng_);
+    if (high < low) std::swap(high, low);
+    q.fiftytwo_week_high = high;
+    q.fiftytwo_week_low = low;
+    double spread = spread_dist(rng_);
+    q.bid = price - spread;
+    q.ask = price + spread;
+    q.timestamp_ns = unixNanos();
+    return q;
+}
+
+
+
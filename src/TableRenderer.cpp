@@ -1,167 +1,232 @@
 #include "TableRenderer.hpp"
-#include <cmath>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <charconv>
 
 namespace {
-std::string truncate(const std::string &text, std::size_t width) {
-    if (text.size() <= width) return text;
-    return text.substr(0, width - 3) + "...";
+constexpr std::size_t kTickerWidth = 8;
+constexpr std::size_t kNameWidth = 20;
+constexpr std::size_t kPriceWidth = 10;
+constexpr std::size_t kCapWidth = 14;
+constexpr std::size_t kPctWidth = 8;
+constexpr std::size_t kVolumeWidth = 14;
+constexpr std::size_t kAvgVolumeWidth = 14;
+constexpr std::size_t kLevelWidth = 12;
+constexpr std::size_t kAlertsWidth = 40;
+constexpr std::size_t kNotesWidth = 30;
+constexpr std::size_t kRuleWidth = kTickerWidth + kNameWidth + kPriceWidth * 3 + kCapWidth + kPctWidth +
+                                   kVolumeWidth * 2 + kLevelWidth * 2 + kAvgVolumeWidth + 10;
+
+// Large enough for any double in fixed notation with two decimals.
+constexpr std::size_t kNumberBuffer = 512;
+
+// Cells follow iostream setw semantics: pad up to `width`, never cut.
+void appendLeft(std::string &out, std::string_view text, std::size_t width) {
+    out.append(text);
+    if (text.size() < width) out.append(width - text.size(), ' ');
+}
+
+void appendRight(std::string &out, std::string_view text, std::size_t width) {
+    if (text.size() < width) out.append(width - text.size(), ' ');
+    out.append(text);
+}
+
+// Text longer than `width` bytes keeps its first width-3 bytes plus "...".
+void appendTruncated(std::string &out, std::string_view text, std::size_t width) {
+    if (text.size() <= width) {
+        out.append(text);
+        return;
+    }
+    out.append(text.substr(0, width - 3)).append("...");
+}
+
+void appendTruncatedLeft(std::string &out, std::string_view text, std::size_t width) {
+    appendTruncated(out, text, width);
+    if (text.size() < width) out.append(width - text.size(), ' ');
+}
+
+// Right-aligned, same digits as printf("%.*f").
+void appendFixed(std::string &out, double value, int precision, std::string_view suffix, std::size_t width) {
+    char digits[kNumberBuffer];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, precision);
+    std::size_t size = static_cast<std::size_t>(result.ptr - digits) + suffix.size();
+    if (size < width) out.append(width - size, ' ');
+    out.append(digits, result.ptr).append(suffix);
+}
+
+void appendNumber(std::string &out, double value, std::size_t width) {
+    appendFixed(out, value, 2, {}, width);
+}
+
+void appendLargeNumber(std::string &out, double value, std::size_t width) {
+    static constexpr std::string_view suffixes[] = {"", "K", "M", "B", "T"};
+    int idx = 0;
+    while (value >= 1000.0 && idx < 4) {
+        value /= 1000.0;
+        ++idx;
+    }
+    appendFixed(out, value, idx == 0 ? 0 : 2, suffixes[idx], width);
+}
+
+void appendInteger(std::string &out, long long value, std::size_t width) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    appendRight(out, std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)), width);
+}
+
+// Alert names wrapped in their colour and a reset, built once.
+const std::array<std::string, kAlertCount> &colorizedAlerts() {
+    static const auto labels = [] {
+        std::array<std::string, kAlertCount> text;
+        for (std::size_t i = 0; i < kAlertCount; ++i) {
+            text[i].append(kAlertTable[i].color).append(kAlertTable[i].name).append("\033[0m");
+        }
+        return text;
+    }();
+    return labels;
+}
+
+void appendHeader(std::string &out, bool withAlerts) {
+    appendLeft(out, "Ticker", kTickerWidth);
+    appendLeft(out, "Name", kNameWidth);
+    appendLeft(out, "Price", kPriceWidth);
+    appendLeft(out, "Market Cap", kCapWidth);
+    appendLeft(out, "%Chg", kPctWidth);
+    appendLeft(out, "Volume", kVolumeWidth);
+    appendLeft(out, "Avg Volume", kAvgVolumeWidth);
+    appendLeft(out, "52W High", kLevelWidth);
+    appendLeft(out, "52W Low", kLevelWidth);
+    appendLeft(out, "Bid", kPriceWidth);
+    appendLeft(out, "Ask", kPriceWidth);
+    if (withAlerts) appendLeft(out, "Alerts", kAlertsWidth);
+    out.append("Notes\n");
+    out.append(kRuleWidth + (withAlerts ? kAlertsWidth : 0), '-').push_back('\n');
 }
 }
 
+TableRenderer::TableRenderer(std::ostream &out) : out_(&out) {}
+
+TableRenderer::TableRenderer(const SymbolTable &names, std::ostream &out) : names_(&names), out_(&out) {}
+
 void TableRenderer::render(const ScreenerRows &rows) {
-    const int ticker_w = 8;
-    const int name_w = 20;
-    const int price_w = 10;
-    const int cap_w = 14;
-    const int pct_w = 8;
-    const int vol_w = 14;
-    const int avg_vol_w = 14;
-    const int level_w = 12;
-
-    std::cout << std::left
-              << std::setw(ticker_w) << "Ticker"
-              << std::setw(name_w) << "Name"
-              << std::setw(price_w) << "Price"
-              << std::setw(cap_w) << "Market Cap"
-              << std::setw(pct_w) << "%Chg"
-              << std::setw(vol_w) << "Volume"
-              << std::setw(avg_vol_w) << "Avg Volume"
-              << std::setw(level_w) << "52W High"
-              << std::setw(level_w) << "52W Low"
-              << std::setw(price_w) << "Bid"
-              << std::setw(price_w) << "Ask"
-              << "Notes"
-              << "\n";
-
-    std::cout << std::string(ticker_w + name_w + price_w * 3 + cap_w + pct_w + vol_w * 2 + level_w * 2 + avg_vol_w + 10, '-')
-              << "\n";
+    auto frame = format(rows);
+    out_->write(frame.data(), static_cast<std::streamsize>(frame.size()));
+}
 
+void TableRenderer::renderWithAlerts(const ScreenerRows &rows, const std::vector<AlertSet> &alerts, bool alertsOnly) {
+    auto frame = formatWithAlerts(rows, alerts, alertsOnly);
+    out_->write(frame.data(), static_cast<std::streamsize>(frame.size()));
+}
+
+std::string_view TableRenderer::format(const ScreenerRows &rows) {
+    frame_.clear();
+    appendHeader(frame_, false);
     for (const auto &row : rows) {
-        const auto &meta = row.first;
-        const auto &q = row.second;
-        std::cout << std::left
-                  << std::setw(ticker_w) << truncate(meta.ticker, ticker_w)
-                  << std::setw(name_w) << truncate(q.name.empty() ? meta.name : q.name, name_w)
-                  << std::right
-                  << std::setw(price_w) << formatNumber(q.price)
-                  << std::setw(cap_w) << formatLargeNumber(q.market_cap)
-                  << std::setw(pct_w) << formatNumber(q.daily_percent_change, 2)
-                  << std::setw(vol_w) << static_cast<long long>(q.volume)
-                  << std::setw(avg_vol_w) << static_cast<long long>(q.average_volume)
-                  << std::setw(level_w) << formatNumber(q.fiftytwo_week_high)
-                  << std::setw(level_w) << formatNumber(q.fiftytwo_week_low)
-                  << std::setw(price_w) << formatNumber(q.bid)
-                  << std::setw(price_w) << formatNumber(q.ask)
-                  << " " << truncate(meta.notes, 30)
-                  << "\n";
+        appendRow(*row.first, row.second);
     }
+    return frame_;
 }
 
-void TableRenderer::renderWithAlerts(const ScreenerRows &rows, const std::vector<std::vector<std::string>> &alerts, bool alertsOnly) {
-    const int ticker_w = 8;
-    const int alerts_w = 40;
-    if (alertsOnly) {
-        std::cout << std::left << std::setw(ticker_w) << "Ticker" << "Alerts" << "\n";
-        std::cout << std::string(ticker_w + alerts_w, '-') << "\n";
-        for (std::size_t i = 0; i < rows.size(); ++i) {
-            const auto &meta = rows[i].first;
-            std::cout << std::left << std::setw(ticker_w) << truncate(meta.ticker, ticker_w)
-                      << truncate(joinAlerts(alerts[i]), alerts_w) << "\n";
-        }
-        return;
+std::string_view TableRenderer::formatWithAlerts(const ScreenerRows &rows, const std::vector<AlertSet> &alerts,
+                                                 bool alertsOnly) {
+    frame_.clear();
+    appendAlertsHeader(alertsOnly);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        appendAlertsRow(*rows[i].first, rows[i].second, alerts[i], alertsOnly);
     }
+    return frame_;
+}
 
-    const int name_w = 20;
-    const int price_w = 10;
-    const int cap_w = 14;
-    const int pct_w = 8;
-    const int vol_w = 14;
-    const int avg_vol_w = 14;
-    const int level_w = 12;
-
-    std::cout << std::left
-              << std::setw(ticker_w) << "Ticker"
-              << std::setw(name_w) << "Name"
-              << std::setw(price_w) << "Price"
-              << std::setw(cap_w) << "Market Cap"
-              << std::setw(pct_w) << "%Chg"
-              << std::setw(vol_w) << "Volume"
-              << std::setw(avg_vol_w) << "Avg Volume"
-              << std::setw(level_w) << "52W High"
-              << std::setw(level_w) << "52W Low"
-              << std::setw(price_w) << "Bid"
-              << std::setw(price_w) << "Ask"
-              << std::setw(alerts_w) << "Alerts"
-              << "Notes"
-              << "\n";
-
-    std::cout << std::string(ticker_w + name_w + price_w * 3 + cap_w + pct_w + vol_w * 2 + level_w * 2 + avg_vol_w + alerts_w + 10, '-')
-              << "\n";
+std::string_view TableRenderer::format(const ScreenerRows &rows, const RowSelection &selection) {
+    frame_.clear();
+    appendHeader(frame_, false);
+    for (std::uint32_t i : selection.rows) {
+        appendRow(*rows[i].first, rows[i].second);
+    }
+    appendFooter(selection, rows.size());
+    return frame_;
+}
 
-    for (std::size_t i = 0; i < rows.size(); ++i) {
-        const auto &meta = rows[i].first;
-        const auto &q = rows[i].second;
-        std::cout << std::left
-                  << std::setw(ticker_w) << truncate(meta.ticker, ticker_w)
-                  << std::setw(name_w) << truncate(q.name.empty() ? meta.name : q.name, name_w)
-                  << std::right
-                  << std::setw(price_w) << formatNumber(q.price)
-                  << std::setw(cap_w) << formatLargeNumber(q.market_cap)
-                  << std::setw(pct_w) << formatNumber(q.daily_percent_change, 2)
-                  << std::setw(vol_w) << static_cast<long long>(q.volume)
-                  << std::setw(avg_vol_w) << static_cast<long long>(q.average_volume)
-                  << std::setw(level_w) << formatNumber(q.fiftytwo_week_high)
-                  << std::setw(level_w) << formatNumber(q.fiftytwo_week_low)
-                  << std::setw(price_w) << formatNumber(q.bid)
-                  << std::setw(price_w) << formatNumber(q.ask)
-                  << std::left << std::setw(alerts_w) << truncate(joinAlerts(alerts[i]), alerts_w)
-                  << truncate(meta.notes, 30)
-                  << "\n";
+std::string_view TableRenderer::formatWithAlerts(const ScreenerRows &rows, const std::vector<AlertSet> &alerts,
+                                                 bool alertsOnly, const RowSelection &selection) {
+    frame_.clear();
+    appendAlertsHeader(alertsOnly);
+    for (std::uint32_t i : selection.rows) {
+        appendAlertsRow(*rows[i].first, rows[i].second, alerts[i], alertsOnly);
     }
+    appendFooter(selection, rows.size());
+    return frame_;
 }
 
-std::string TableRenderer::formatNumber(double value, int precision) {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(precision) << value;
-    return oss.str();
+void TableRenderer::appendRow(const TickerRecord &meta, const Quote &q) {
+    appendQuoteColumns(meta, q);
+    frame_.push_back(' ');
+    appendTruncated(frame_, meta.notes, kNotesWidth);
+    frame_.push_back('\n');
 }
 
-std::string TableRenderer::formatLargeNumber(double value) {
-    const char *suffixes[] = {"", "K", "M", "B", "T"};
-    int idx = 0;
-    while (value >= 1000.0 && idx < 4) {
-        value /= 1000.0;
-        ++idx;
+void TableRenderer::appendAlertsHeader(bool alertsOnly) {
+    if (!alertsOnly) {
+        appendHeader(frame_, true);
+        return;
     }
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(idx == 0 ? 0 : 2) << value << suffixes[idx];
-    return oss.str();
-}
-
-std::string TableRenderer::colorize(const std::string &alert) {
-    const std::string reset = "\033[0m";
-    std::string color;
-    if (alert == "VOL_SPIKE" || alert == "VOLATILITY_SURGE") {
-        color = "\033[33m"; // yellow
-    } else if (alert == "BREAKOUT_UP") {
-        color = "\033[32m"; // green
-    } else if (alert == "MOMENTUM_FLIP") {
-        color = "\033[34m"; // blue
+    appendLeft(frame_, "Ticker", kTickerWidth);
+    frame_.append("Alerts\n");
+    frame_.append(kTickerWidth + kAlertsWidth, '-').push_back('\n');
+}
+
+void TableRenderer::appendAlertsRow(const TickerRecord &meta, const Quote &q, AlertSet alerts, bool alertsOnly) {
+    if (alertsOnly) {
+        appendTruncatedLeft(frame_, meta.ticker, kTickerWidth);
+        appendTruncated(frame_, joinAlerts(alerts), kAlertsWidth);
+        frame_.push_back('\n');
+        return;
+    }
+    appendQuoteColumns(meta, q);
+    // Truncated and padded by bytes, colour codes included.
+    appendTruncatedLeft(frame_, joinAlerts(alerts), kAlertsWidth);
+    appendTruncated(frame_, meta.notes, kNotesWidth);
+    frame_.push_back('\n');
+}
+
+void TableRenderer::appendFooter(const RowSelection &selection, std::size_t total) {
+    frame_.append("Rows ");
+    if (selection.rows.empty()) {
+        frame_.push_back('-');
     } else {
-        color = "\033[31m"; // red for negative conditions
+        appendInteger(frame_, static_cast<long long>(selection.first_rank + 1), 0);
+        frame_.push_back('-');
+        appendInteger(frame_, static_cast<long long>(selection.first_rank + selection.rows.size()), 0);
     }
-    return color + alert + reset;
+    frame_.append(" of ");
+    appendInteger(frame_, static_cast<long long>(total), 0);
+    frame_.push_back('\n');
+}
+
+// Ticker through Ask, the columns both table layouts share.
+void TableRenderer::appendQuoteColumns(const TickerRecord &meta, const Quote &q) {
+    appendTruncatedLeft(frame_, meta.ticker, kTickerWidth);
+    appendTruncatedLeft(frame_, names_ ? names_->displayName(meta.id, meta.name) : std::string_view(meta.name),
+                        kNameWidth);
+    appendNumber(frame_, q.price, kPriceWidth);
+    appendLargeNumber(frame_, q.market_cap, kCapWidth);
+    appendNumber(frame_, q.daily_percent_change, kPctWidth);
+    appendInteger(frame_, q.volume, kVolumeWidth);
+    appendInteger(frame_, q.average_volume, kAvgVolumeWidth);
+    appendNumber(frame_, q.fiftytwo_week_high, kLevelWidth);
+    appendNumber(frame_, q.fiftytwo_week_low, kLevelWidth);
+    appendNumber(frame_, q.bid, kPriceWidth);
+    appendNumber(frame_, q.ask, kPriceWidth);
 }
 
-std::string TableRenderer::joinAlerts(const std::vector<std::string> &alerts) {
-    if (alerts.empty()) return "-";
-    std::ostringstream oss;
-    for (std::size_t i = 0; i < alerts.size(); ++i) {
-        if (i > 0) oss << ", ";
-        oss << colorize(alerts[i]);
+std::string_view TableRenderer::joinAlerts(AlertSet alerts) {
+    if (alerts == 0) return "-";
+    const auto &labels = colorizedAlerts();
+    alerts_text_.clear();
+    for (std::size_t i = 0; i < kAlertCount; ++i) {
+        if (!hasAlert(alerts, static_cast<AlertCode>(i))) continue;
+        if (!alerts_text_.empty()) alerts_text_.append(", ");
+        alerts_text_.append(labels[i]);
     }
-    return oss.str();
+    return alerts_text_;
 }
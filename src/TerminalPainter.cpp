@@ -0,0 +1,192 @@
+#include "TerminalPainter.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::size_t kUnknown = std::numeric_limits<std::size_t>::max();
+
+// Unchanged cells shorter than this are rewritten rather than skipped with a
+// cursor move, which costs about as many bytes.
+constexpr std::size_t kMaxGap = 6;
+
+void appendNumber(std::string &out, std::size_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+}
+
+bool TerminalPainter::Cell::operator==(const Cell &other) const {
+    return size == other.size && style == other.style && std::memcmp(glyph, other.glyph, size) == 0;
+}
+
+TerminalPainter::TerminalPainter(RepaintMode mode, int fd) : mode_(mode), fd_(fd), styles_{""} {}
+
+TerminalPainter::~TerminalPainter() {
+    if (!cursor_hidden_) return;
+    out_.clear();
+    out_.append("\033[0m\033[");
+    appendNumber(out_, rows_);
+    out_.append(";1H\n\033[?25h");
+    flush();
+}
+
+bool TerminalPainter::paint(std::string_view frame) {
+    out_.clear();
+    if (mode_ == RepaintMode::Full || !updateSize()) {
+        out_.append("\033[2J\033[H"); // clear screen and move cursor home
+        out_.append(frame);
+        return flush();
+    }
+
+    if (!cursor_hidden_) {
+        out_.append("\033[?25l");
+        cursor_hidden_ = true;
+    }
+    layout(frame);
+    emitChanges();
+    current_.swap(next_);
+    return flush();
+}
+
+std::size_t TerminalPainter::lastFrameBytes() const {
+    return out_.size();
+}
+
+// Picks up the window size. A new size clears the screen and resets the
+// previous grid to blanks, so the next diff redraws everything.
+bool TerminalPainter::updateSize() {
+    winsize size{};
+    if (::ioctl(fd_, TIOCGWINSZ, &size) != 0 || size.ws_row == 0 || size.ws_col == 0) {
+        return false;
+    }
+    if (size.ws_row == rows_ && size.ws_col == cols_) return true;
+
+    rows_ = size.ws_row;
+    cols_ = size.ws_col;
+    current_.assign(rows_ * cols_, Cell{});
+    next_.assign(rows_ * cols_, Cell{});
+    out_.append("\033[0m\033[2J");
+    active_style_ = 0;
+    cursor_row_ = kUnknown;
+    cursor_col_ = kUnknown;
+    return true;
+}
+
+void TerminalPainter::layout(std::string_view frame) {
+    std::fill(next_.begin(), next_.end(), Cell{});
+    std::size_t row = 0;
+    std::size_t col = 0;
+    std::uint8_t style = 0;
+    for (std::size_t i = 0; i < frame.size() && row < rows_; ++i) {
+        char c = frame[i];
+        auto byte = static_cast<unsigned char>(c);
+        if (c == '\n') {
+            ++row;
+            col = 0;
+        } else if (c == '\r') {
+            col = 0;
+        } else if (c == '\033') {
+            // Keep SGR colour changes, drop any other control sequence.
+            if (i + 1 < frame.size() && frame[i + 1] == '[') {
+                std::size_t end = i + 2;
+                while (end < frame.size() && (frame[end] < 0x40 || frame[end] > 0x7e)) ++end;
+                if (end == frame.size()) break;
+                if (frame[end] == 'm') style = internStyle(frame.substr(i, end - i + 1));
+                i = end;
+            }
+        } else if ((byte & 0xc0) == 0x80) {
+            // UTF-8 continuation byte: belongs to the previous cell.
+            if (col > 0 && col <= cols_) {
+                Cell &cell = next_[row * cols_ + col - 1];
+                if (cell.size < sizeof(cell.glyph)) cell.glyph[cell.size++] = c;
+            }
+        } else if (byte >= 0x20) {
+            if (col < cols_) {
+                Cell &cell = next_[row * cols_ + col];
+                cell.glyph[0] = c;
+                cell.size = 1;
+                cell.style = style;
+            }
+            ++col;
+        }
+    }
+}
+
+std::uint8_t TerminalPainter::internStyle(std::string_view sequence) {
+    if (sequence == "\033[0m" || sequence == "\033[m") return 0;
+    for (std::size_t i = 1; i < styles_.size(); ++i) {
+        if (styles_[i] == sequence) return static_cast<std::uint8_t>(i);
+    }
+    if (styles_.size() > std::numeric_limits<std::uint8_t>::max()) return 0;
+    styles_.emplace_back(sequence);
+    return static_cast<std::uint8_t>(styles_.size() - 1);
+}
+
+void TerminalPainter::emitChanges() {
+    for (std::size_t row = 0; row < rows_; ++row) {
+        const Cell *previous = current_.data() + row * cols_;
+        const Cell *cells = next_.data() + row * cols_;
+        std::size_t col = 0;
+        while (col < cols_) {
+            if (cells[col] == previous[col]) {
+                ++col;
+                continue;
+            }
+            std::size_t end = col + 1;
+            for (std::size_t gap = 0, j = end; j < cols_ && gap <= kMaxGap; ++j) {
+                if (cells[j] == previous[j]) {
+                    ++gap;
+                } else {
+                    end = j + 1;
+                    gap = 0;
+                }
+            }
+
+            moveTo(row, col);
+            for (; col < end; ++col) {
+                setStyle(cells[col].style);
+                out_.append(cells[col].glyph, cells[col].size);
+            }
+            // Writing the last column leaves the cursor in a pending-wrap state.
+            cursor_col_ = end < cols_ ? end : kUnknown;
+        }
+    }
+    setStyle(0);
+}
+
+void TerminalPainter::moveTo(std::size_t row, std::size_t col) {
+    if (row == cursor_row_ && col == cursor_col_) return;
+    out_.append("\033[");
+    appendNumber(out_, row + 1);
+    out_.push_back(';');
+    appendNumber(out_, col + 1);
+    out_.push_back('H');
+    cursor_row_ = row;
+    cursor_col_ = col;
+}
+
+void TerminalPainter::setStyle(std::uint8_t style) {
+    if (style == active_style_) return;
+    if (active_style_ != 0 || style == 0) out_.append("\033[0m");
+    out_.append(styles_[style]);
+    active_style_ = style;
+}
+
+bool TerminalPainter::flush() {
+    std::string_view data(out_);
+    while (!data.empty()) {
+        ssize_t written = ::write(fd_, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
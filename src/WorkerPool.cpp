@@ -0,0 +1,84 @@
+#include "WorkerPool.hpp"
+#include <algorithm>
+#include <utility>
+
+WorkerPool::WorkerPool(std::size_t workers) : workers_(std::max<std::size_t>(workers, 1)) {
+    threads_.reserve(workers_ - 1);
+    for (std::size_t w = 1; w < workers_; ++w) {
+        threads_.emplace_back([this, w] { workerLoop(w); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+std::size_t WorkerPool::size() const { return workers_; }
+
+void WorkerPool::parallelFor(std::size_t count, const ChunkFn &fn) {
+    if (count == 0) return;
+    if (workers_ == 1) {
+        fn(0, 0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submit_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        job_count_ = count;
+        pending_ = workers_ - 1;
+        ++generation_;
+    }
+    start_cv_.notify_all();
+
+    runChunk(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+    job_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+void WorkerPool::workerLoop(std::size_t worker) {
+    std::size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+
+        runChunk(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::runChunk(std::size_t worker) {
+    std::size_t chunk = (job_count_ + workers_ - 1) / workers_;
+    std::size_t begin = std::min(job_count_, worker * chunk);
+    std::size_t end = std::min(job_count_, begin + chunk);
+    if (begin >= end) return;
+    // Workers must not unwind out of their loop, and the caller must not
+    // leave parallelFor while workers still run through job_.
+    try {
+        (*job_)(worker, begin, end);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) error_ = std::current_exception();
+    }
+}
@@ -1,5 +1,6 @@
 #include "quantis/anomaly/AnomalyEngine.hpp"
 #include <cmath>
+#include <stdexcept>
 
 namespace {
 bool oppositeSigns(double a, double b) {
@@ -7,22 +8,33 @@ bool oppositeSigns(double a, double b) {
 }
 }
 
-std::vector<std::string> AnomalyEngine::evaluate(const std::string &ticker, const Quote &quote) {
-    auto &buffer = buffers_[ticker];
+AnomalyEngine::AnomalyEngine() {
+    owned_symbols_ = std::make_unique<SymbolTable>();
+    symbols_ = owned_symbols_.get();
+}
+
+AnomalyEngine::AnomalyEngine(SymbolTable &symbols) : symbols_(&symbols) {}
+
+AlertSet AnomalyEngine::evaluate(const std::string &ticker, const Quote &quote) {
+    return evaluate(symbols_->intern(ticker), quote);
+}
+
+AlertSet AnomalyEngine::evaluate(TickerId id, const Quote &quote) {
+    auto &buffer = bufferFor(id);
     buffer.addSample(quote);
 
-    std::vector<std::string> alerts;
+    AlertSet alerts = 0;
 
     // Rule A: Unusual volume
     if (quote.average_volume > 0 && static_cast<double>(quote.volume) / static_cast<double>(quote.average_volume) > 2.0) {
-        alerts.emplace_back("VOL_SPIKE");
+        alerts |= alertBit(AlertCode::VolSpike);
     }
 
     // Rule B: Volatility surge
     double price_ret = buffer.priceReturn();
     double recent_vol = buffer.recentVolatility();
     if (recent_vol > 0.0 && std::abs(price_ret) > 1.5 * recent_vol) {
-        alerts.emplace_back("VOLATILITY_SURGE");
+        alerts |= alertBit(AlertCode::VolatilitySurge);
     }
 
     double spread = buffer.latestSpread();
@@ -30,20 +42,20 @@ std::vector<std::string> AnomalyEngine::evaluate(const std::string &ticker, cons
 
     // Rule C: Spread widening
     if (mean_spread > 0.0 && spread > mean_spread * 2.0) {
-        alerts.emplace_back("SPREAD_WIDE");
+        alerts |= alertBit(AlertCode::SpreadWide);
     }
 
     // Rule D: Price breakout
     if (quote.price > quote.fiftytwo_week_high * 0.995) {
-        alerts.emplace_back("BREAKOUT_UP");
+        alerts |= alertBit(AlertCode::BreakoutUp);
     } else if (quote.price < quote.fiftytwo_week_low * 1.005) {
-        alerts.emplace_back("BREAKOUT_DOWN");
+        alerts |= alertBit(AlertCode::BreakoutDown);
     }
 
     // Rule E: Liquidity compression
     if (quote.average_volume > 0 && quote.volume < static_cast<long long>(quote.average_volume * 0.4) &&
         mean_spread > 0.0 && spread > mean_spread * 1.5) {
-        alerts.emplace_back("LOW_LIQUIDITY");
+        alerts |= alertBit(AlertCode::LowLiquidity);
     }
 
     // Rule F: Momentum shift
@@ -51,11 +63,59 @@ std::vector<std::string> AnomalyEngine::evaluate(const std::string &ticker, cons
     double long_slope = buffer.longTermSlope();
     if (buffer.size() >= 10 && oppositeSigns(short_slope, long_slope) &&
         std::abs(short_slope) > std::abs(long_slope) * 1.5) {
-        alerts.emplace_back("MOMENTUM_FLIP");
+        alerts |= alertBit(AlertCode::MomentumFlip);
     }
 
     return alerts;
 }
 
+void AnomalyEngine::evaluateBatch(std::span<const TickerId> ids, std::span<const Quote> quotes, std::span<AlertSet> out,
+                                  RuleKernel kernel) {
+    if (ids.size() != quotes.size() || out.size() < quotes.size()) {
+        throw std::invalid_argument("evaluateBatch: mismatched batch sizes");
+    }
+
+    thread_local RuleColumns columns;
+    const std::size_t count = quotes.size();
+    columns.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const Quote &quote = quotes[i];
+        auto &buffer = bufferFor(ids[i]);
+        buffer.addSample(quote);
+
+        bool has_average = quote.average_volume > 0;
+        columns.volume_ratio[i] =
+            has_average ? static_cast<double>(quote.volume) / static_cast<double>(quote.average_volume) : 0.0;
+        columns.thin_volume[i] =
+            has_average && quote.volume < static_cast<long long>(quote.average_volume * 0.4) ? 1.0 : 0.0;
+        columns.price[i] = quote.price;
+        columns.fiftytwo_week_high[i] = quote.fiftytwo_week_high;
+        columns.fiftytwo_week_low[i] = quote.fiftytwo_week_low;
+        columns.spread[i] = buffer.latestSpread();
+        columns.mean_spread[i] = buffer.meanSpread();
+        columns.price_return[i] = buffer.priceReturn();
+        columns.volatility[i] = buffer.recentVolatility();
+        columns.short_slope[i] = buffer.shortTermSlope();
+        columns.long_slope[i] = buffer.longTermSlope();
+        columns.history[i] = static_cast<double>(buffer.size());
+    }
+
+    evaluateRules(columns, count, out.data(), kernel);
+}
+
+void AnomalyEngine::ensureTickers(std::size_t tickers) {
+    if (buffers_.size() < tickers) {
+        buffers_.resize(tickers);
+    }
+}
+
 void AnomalyEngine::clear() { buffers_.clear(); }
 
+StatsBuffer &AnomalyEngine::bufferFor(TickerId id) {
+    if (id >= buffers_.size()) {
+        buffers_.resize(static_cast<std::size_t>(id) + 1);
+    }
+    return buffers_[id];
+}
+
@@ -0,0 +1,162 @@
+#include "quantis/anomaly/AnomalySnapshot.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace anomaly_snapshot {
+
+namespace {
+constexpr std::size_t kWriteChunk = 1 << 20;
+
+bool writeAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+template <typename T>
+void append(std::string &out, const T &value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+}
+
+void capture(const ShardedAnomalyEngine &engine, const std::function<std::string_view(TickerId)> &symbolOf,
+             std::string &image) {
+    std::vector<std::pair<std::string_view, const StatsBuffer *>> entries;
+    std::uint64_t names_size = 0;
+    engine.forEachWindow([&](TickerId id, const StatsBuffer &window) {
+        std::string_view symbol = symbolOf(id);
+        if (symbol.empty() || window.capacity() != StatsBuffer::kDefaultCapacity) return;
+        entries.emplace_back(symbol, &window);
+        names_size += symbol.size();
+    });
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.window = StatsBuffer::kDefaultCapacity;
+    header.tickers = entries.size();
+    header.record_size = kRecordSize;
+    header.names_offset = sizeof(FileHeader) + entries.size() * kRecordSize;
+    header.names_size = names_size;
+    header.saved_at = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+
+    image.clear();
+    image.reserve(header.names_offset + names_size);
+    append(image, header);
+    std::vector<StatsBuffer::Sample> samples(StatsBuffer::kDefaultCapacity);
+    std::uint64_t name_offset = 0;
+    for (const auto &[symbol, window] : entries) {
+        RecordHeader record{name_offset, static_cast<std::uint32_t>(symbol.size()),
+                            static_cast<std::uint32_t>(window->size()), window->aggregates()};
+        std::fill(samples.begin(), samples.end(), StatsBuffer::Sample{0.0, 0.0});
+        window->copyWindow(samples);
+        append(image, record);
+        image.append(reinterpret_cast<const char *>(samples.data()), samples.size() * sizeof(StatsBuffer::Sample));
+        name_offset += symbol.size();
+    }
+    for (const auto &entry : entries) {
+        image += entry.first;
+    }
+}
+
+bool write(const std::string &path, std::string_view image) {
+    std::string temp = path + ".tmp";
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    bool ok = true;
+    for (std::size_t offset = 0; ok && offset < image.size(); offset += kWriteChunk) {
+        ok = writeAll(fd, image.substr(offset, kWriteChunk));
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    ok = ok && ::rename(temp.c_str(), path.c_str()) == 0;
+    if (!ok) {
+        int saved = errno;
+        ::unlink(temp.c_str());
+        errno = saved;
+    }
+    return ok;
+}
+
+bool save(const std::string &path, const ShardedAnomalyEngine &engine,
+          const std::function<std::string_view(TickerId)> &symbolOf) {
+    std::string image;
+    capture(engine, symbolOf, image);
+    return write(path, image);
+}
+
+std::optional<RestoreResult> restore(const std::string &path, ShardedAnomalyEngine &engine,
+                                     const std::function<TickerId(std::string_view)> &idOf,
+                                     std::chrono::seconds max_age) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return std::nullopt;
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    auto size = static_cast<std::size_t>(info.st_size);
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return std::nullopt;
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+    const char *base = static_cast<const char *>(mapping);
+
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+                 header.window == StatsBuffer::kDefaultCapacity && header.record_size == kRecordSize &&
+                 header.tickers <= (size - sizeof(FileHeader)) / kRecordSize &&
+                 header.names_offset == sizeof(FileHeader) + header.tickers * kRecordSize &&
+                 header.names_size == size - header.names_offset;
+    if (!valid) {
+        ::munmap(mapping, size);
+        return std::nullopt;
+    }
+
+    RestoreResult result;
+    result.saved_at = header.saved_at;
+    auto saved = std::chrono::system_clock::time_point(std::chrono::nanoseconds(header.saved_at));
+    if (std::chrono::system_clock::now() - saved > max_age) {
+        ::munmap(mapping, size);
+        result.expired = true;
+        return result;
+    }
+    const char *names = base + header.names_offset;
+    for (std::uint64_t i = 0; i < header.tickers; ++i) {
+        const char *record = base + sizeof(FileHeader) + i * kRecordSize;
+        RecordHeader entry;
+        std::memcpy(&entry, record, sizeof(entry));
+        if (entry.name_offset > header.names_size || entry.name_length > header.names_size - entry.name_offset ||
+            entry.count > header.window) {
+            continue;
+        }
+        TickerId id = idOf(std::string_view(names + entry.name_offset, entry.name_length));
+        if (id == SymbolTable::kInvalidId) continue;
+        // Records are 8-byte aligned within the page-aligned mapping.
+        std::span<const StatsBuffer::Sample> window(
+            reinterpret_cast<const StatsBuffer::Sample *>(record + sizeof(RecordHeader)), entry.count);
+        engine.window(id).restore(window, entry.aggregates);
+        ++result.tickers;
+    }
+    ::munmap(mapping, size);
+    return result;
+}
+
+} // namespace anomaly_snapshot
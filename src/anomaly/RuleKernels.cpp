@@ -0,0 +1,153 @@
+#include "quantis/anomaly/RuleKernels.hpp"
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define QUANTIS_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+void RuleColumns::resize(std::size_t count) {
+    for (auto *column : {&volume_ratio, &thin_volume, &price, &fiftytwo_week_high, &fiftytwo_week_low, &spread,
+                         &mean_spread, &price_return, &volatility, &short_slope, &long_slope, &history}) {
+        column->resize(count);
+    }
+}
+
+namespace {
+// Mirrors the rule order and comparisons of AnomalyEngine::evaluate exactly.
+void evaluateRange(const RuleColumns &c, std::size_t begin, std::size_t end, AlertSet *out) {
+    for (std::size_t i = begin; i < end; ++i) {
+        AlertSet alerts = 0;
+
+        if (c.volume_ratio[i] > 2.0) {
+            alerts |= alertBit(AlertCode::VolSpike);
+        }
+        if (c.volatility[i] > 0.0 && std::abs(c.price_return[i]) > 1.5 * c.volatility[i]) {
+            alerts |= alertBit(AlertCode::VolatilitySurge);
+        }
+        if (c.mean_spread[i] > 0.0 && c.spread[i] > c.mean_spread[i] * 2.0) {
+            alerts |= alertBit(AlertCode::SpreadWide);
+        }
+        if (c.price[i] > c.fiftytwo_week_high[i] * 0.995) {
+            alerts |= alertBit(AlertCode::BreakoutUp);
+        } else if (c.price[i] < c.fiftytwo_week_low[i] * 1.005) {
+            alerts |= alertBit(AlertCode::BreakoutDown);
+        }
+        if (c.thin_volume[i] > 0.0 && c.mean_spread[i] > 0.0 && c.spread[i] > c.mean_spread[i] * 1.5) {
+            alerts |= alertBit(AlertCode::LowLiquidity);
+        }
+        double s = c.short_slope[i];
+        double l = c.long_slope[i];
+        if (c.history[i] >= 10.0 && ((s > 0 && l < 0) || (s < 0 && l > 0)) && std::abs(s) > std::abs(l) * 1.5) {
+            alerts |= alertBit(AlertCode::MomentumFlip);
+        }
+
+        out[i] = alerts;
+    }
+}
+
+#ifdef QUANTIS_HAVE_AVX2_KERNEL
+__attribute__((target("avx2"))) inline void scatterBits(int mask, AlertCode code, AlertSet *out) {
+    AlertSet bit = alertBit(code);
+    out[0] |= (mask & 1) ? bit : 0;
+    out[1] |= (mask & 2) ? bit : 0;
+    out[2] |= (mask & 4) ? bit : 0;
+    out[3] |= (mask & 8) ? bit : 0;
+}
+
+__attribute__((target("avx2"))) std::size_t evaluateAvx2(const RuleColumns &c, std::size_t count, AlertSet *out) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d one_half = _mm256_set1_pd(1.5);
+    const __m256d upper_band = _mm256_set1_pd(0.995);
+    const __m256d lower_band = _mm256_set1_pd(1.005);
+    const __m256d ten = _mm256_set1_pd(10.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d ratio = _mm256_loadu_pd(&c.volume_ratio[i]);
+        __m256d thin = _mm256_loadu_pd(&c.thin_volume[i]);
+        __m256d price = _mm256_loadu_pd(&c.price[i]);
+        __m256d high = _mm256_loadu_pd(&c.fiftytwo_week_high[i]);
+        __m256d low = _mm256_loadu_pd(&c.fiftytwo_week_low[i]);
+        __m256d spread = _mm256_loadu_pd(&c.spread[i]);
+        __m256d mean_spread = _mm256_loadu_pd(&c.mean_spread[i]);
+        __m256d ret = _mm256_loadu_pd(&c.price_return[i]);
+        __m256d vol = _mm256_loadu_pd(&c.volatility[i]);
+        __m256d s = _mm256_loadu_pd(&c.short_slope[i]);
+        __m256d l = _mm256_loadu_pd(&c.long_slope[i]);
+        __m256d history = _mm256_loadu_pd(&c.history[i]);
+
+        AlertSet *dst = out + i;
+        dst[0] = dst[1] = dst[2] = dst[3] = 0;
+
+        // Rule A: unusual volume
+        scatterBits(_mm256_movemask_pd(_mm256_cmp_pd(ratio, two, _CMP_GT_OQ)), AlertCode::VolSpike, dst);
+
+        // Rule B: volatility surge
+        __m256d surge = _mm256_and_pd(_mm256_cmp_pd(vol, zero, _CMP_GT_OQ),
+                                      _mm256_cmp_pd(_mm256_andnot_pd(sign, ret), _mm256_mul_pd(one_half, vol), _CMP_GT_OQ));
+        scatterBits(_mm256_movemask_pd(surge), AlertCode::VolatilitySurge, dst);
+
+        // Rule C: spread widening
+        __m256d has_spread = _mm256_cmp_pd(mean_spread, zero, _CMP_GT_OQ);
+        __m256d wide = _mm256_and_pd(has_spread, _mm256_cmp_pd(spread, _mm256_mul_pd(mean_spread, two), _CMP_GT_OQ));
+        scatterBits(_mm256_movemask_pd(wide), AlertCode::SpreadWide, dst);
+
+        // Rule D: price breakout (down only when not up)
+        __m256d up = _mm256_cmp_pd(price, _mm256_mul_pd(high, upper_band), _CMP_GT_OQ);
+        __m256d down = _mm256_andnot_pd(up, _mm256_cmp_pd(price, _mm256_mul_pd(low, lower_band), _CMP_LT_OQ));
+        scatterBits(_mm256_movemask_pd(up), AlertCode::BreakoutUp, dst);
+        scatterBits(_mm256_movemask_pd(down), AlertCode::BreakoutDown, dst);
+
+        // Rule E: liquidity compression
+        __m256d compressed = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(thin, zero, _CMP_GT_OQ), has_spread),
+                                           _mm256_cmp_pd(spread, _mm256_mul_pd(mean_spread, one_half), _CMP_GT_OQ));
+        scatterBits(_mm256_movemask_pd(compressed), AlertCode::LowLiquidity, dst);
+
+        // Rule F: momentum shift
+        __m256d opposite = _mm256_or_pd(
+            _mm256_and_pd(_mm256_cmp_pd(s, zero, _CMP_GT_OQ), _mm256_cmp_pd(l, zero, _CMP_LT_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(s, zero, _CMP_LT_OQ), _mm256_cmp_pd(l, zero, _CMP_GT_OQ)));
+        __m256d steeper = _mm256_cmp_pd(_mm256_andnot_pd(sign, s), _mm256_mul_pd(_mm256_andnot_pd(sign, l), one_half),
+                                        _CMP_GT_OQ);
+        __m256d flip = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(history, ten, _CMP_GE_OQ), opposite), steeper);
+        scatterBits(_mm256_movemask_pd(flip), AlertCode::MomentumFlip, dst);
+    }
+    return i;
+}
+
+bool cpuHasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+}
+
+bool ruleKernelAvailable(RuleKernel kernel) {
+    switch (kernel) {
+    case RuleKernel::Auto:
+    case RuleKernel::Scalar:
+        return true;
+    case RuleKernel::Avx2:
+#ifdef QUANTIS_HAVE_AVX2_KERNEL
+        return cpuHasAvx2();
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+void evaluateRules(const RuleColumns &columns, std::size_t count, AlertSet *out, RuleKernel kernel) {
+    std::size_t done = 0;
+#ifdef QUANTIS_HAVE_AVX2_KERNEL
+    if (kernel != RuleKernel::Scalar && cpuHasAvx2()) {
+        done = evaluateAvx2(columns, count, out);
+    }
+#else
+    (void)kernel;
+#endif
+    evaluateRange(columns, done, count, out);
+}
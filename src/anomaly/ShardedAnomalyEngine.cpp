@@ -0,0 +1,143 @@
+#include "quantis/anomaly/ShardedAnomalyEngine.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+constexpr unsigned kBlockShift = 6;
+constexpr TickerId kBlockMask = (TickerId{1} << kBlockShift) - 1;
+// evaluate() waits for each tick, so a shard never has more than a tick and
+// a stop request queued.
+constexpr std::size_t kQueueDepth = 4;
+}
+
+ShardedAnomalyEngine::Shard::Shard() : queue(kQueueDepth) {}
+
+ShardedAnomalyEngine::ShardedAnomalyEngine(std::size_t shards) {
+    shards = std::max<std::size_t>(shards, 1);
+    for (std::size_t i = 0; i < shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    for (std::size_t i = 1; i < shards; ++i) {
+        shards_[i]->thread = std::thread([this, i] { shardLoop(i); });
+    }
+}
+
+ShardedAnomalyEngine::~ShardedAnomalyEngine() {
+    for (std::size_t i = 1; i < shards_.size(); ++i) {
+        push(*shards_[i], Task{.stop = true});
+        shards_[i]->thread.join();
+    }
+}
+
+void ShardedAnomalyEngine::evaluate(std::span<const TickerId> ids, std::span<const Quote> quotes,
+                                    std::span<AlertSet> out) {
+    if (ids.size() != quotes.size() || out.size() < quotes.size()) {
+        throw std::invalid_argument("ShardedAnomalyEngine::evaluate: mismatched batch sizes");
+    }
+
+    Task task;
+    std::uint64_t requested = clear_requests_.load(std::memory_order_acquire);
+    task.clear = requested != clears_applied_;
+    clears_applied_ = requested;
+
+    // With one shard, local ids are the ids themselves.
+    if (shards_.size() == 1) {
+        auto &engine = shards_[0]->engine;
+        if (task.clear) engine.clear();
+        engine.evaluateBatch(ids, quotes, out);
+        return;
+    }
+
+    if (!std::equal(ids.begin(), ids.end(), layout_ids_.begin(), layout_ids_.end())) {
+        layout_ids_.assign(ids.begin(), ids.end());
+        task.relayout = true;
+    }
+    tick_ids_ = ids;
+    tick_quotes_ = quotes;
+    tick_out_ = out;
+
+    pending_.store(static_cast<std::uint32_t>(shards_.size() - 1), std::memory_order_relaxed);
+    for (std::size_t i = 1; i < shards_.size(); ++i) {
+        push(*shards_[i], task);
+    }
+    process(0, task);
+    for (std::uint32_t left; (left = pending_.load(std::memory_order_acquire)) != 0;) {
+        pending_.wait(left, std::memory_order_acquire);
+    }
+}
+
+void ShardedAnomalyEngine::clear() { clear_requests_.fetch_add(1, std::memory_order_acq_rel); }
+
+void ShardedAnomalyEngine::forEachWindow(const std::function<void(TickerId, const StatsBuffer &)> &visit) const {
+    if (clear_requests_.load(std::memory_order_acquire) != clears_applied_) return;
+    const TickerId count = static_cast<TickerId>(shards_.size());
+    for (TickerId shard = 0; shard < count; ++shard) {
+        auto windows = shards_[shard]->engine.windows();
+        for (TickerId local = 0; local < windows.size(); ++local) {
+            if (windows[local].empty()) continue;
+            visit(((local >> kBlockShift) * count + shard) << kBlockShift | (local & kBlockMask), windows[local]);
+        }
+    }
+}
+
+StatsBuffer &ShardedAnomalyEngine::window(TickerId id) {
+    const TickerId count = static_cast<TickerId>(shards_.size());
+    TickerId block = id >> kBlockShift;
+    return shards_[block % count]->engine.window((block / count) << kBlockShift | (id & kBlockMask));
+}
+
+void ShardedAnomalyEngine::push(Shard &shard, Task task) {
+    while (!shard.queue.tryPush(std::move(task))) {
+        std::this_thread::yield();
+    }
+    shard.signal.fetch_add(1, std::memory_order_release);
+    shard.signal.notify_one();
+}
+
+void ShardedAnomalyEngine::shardLoop(std::size_t index) {
+    Shard &shard = *shards_[index];
+    Task task;
+    while (true) {
+        std::uint32_t seen = shard.signal.load(std::memory_order_acquire);
+        if (!shard.queue.tryPop(task)) {
+            shard.signal.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+        if (task.stop) return;
+        process(index, task);
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pending_.notify_one();
+        }
+    }
+}
+
+// Runs one tick for one shard. Only this shard's StatsBuffers and scratch
+// are touched, and only this shard's entries of the output are written.
+void ShardedAnomalyEngine::process(std::size_t index, const Task &task) {
+    Shard &shard = *shards_[index];
+    if (task.clear) {
+        shard.engine.clear();
+    }
+    if (task.relayout) {
+        const TickerId count = static_cast<TickerId>(shards_.size());
+        shard.positions.clear();
+        shard.local_ids.clear();
+        for (std::size_t i = 0; i < tick_ids_.size(); ++i) {
+            TickerId block = tick_ids_[i] >> kBlockShift;
+            if (block % count != index) continue;
+            shard.positions.push_back(static_cast<std::uint32_t>(i));
+            shard.local_ids.push_back((block / count) << kBlockShift | (tick_ids_[i] & kBlockMask));
+        }
+        shard.quotes.resize(shard.positions.size());
+        shard.alerts.resize(shard.positions.size());
+    }
+
+    const std::size_t n = shard.positions.size();
+    for (std::size_t k = 0; k < n; ++k) {
+        shard.quotes[k] = tick_quotes_[shard.positions[k]];
+    }
+    shard.engine.evaluateBatch(shard.local_ids, shard.quotes, shard.alerts);
+    for (std::size_t k = 0; k < n; ++k) {
+        tick_out_[shard.positions[k]] = shard.alerts[k];
+    }
+}
@@ -1,85 +1,151 @@
 #include "quantis/anomaly/StatsBuffer.hpp"
+#include <algorithm>
 #include <cmath>
-#include <numeric>
 
-StatsBuffer::StatsBuffer(std::size_t capacity) : capacity_(capacity) {}
+StatsBuffer::StatsBuffer(std::size_t capacity)
+    : ring_(std::max<std::size_t>(capacity, 1)), capacity_(std::max<std::size_t>(capacity, 1)) {}
 
 void StatsBuffer::addSample(const Quote &quote) {
-    if (samples_.size() == capacity_) {
-        samples_.pop_front();
+    Sample sample{quote.price, quote.ask - quote.bid};
+
+    if (count_ == capacity_) {
+        const Sample &oldest = at(0);
+        if (count_ >= 2) {
+            popReturn(returnBetween(oldest, at(1)));
+        }
+        spread_sum_ -= oldest.spread;
+        head_ = (head_ + 1) % capacity_;
+        --count_;
+        ++evictions_;
+    }
+
+    if (count_ > 0) {
+        pushReturn(returnBetween(at(count_ - 1), sample));
+    }
+    spread_sum_ += sample.spread;
+    ring_[(head_ + count_) % capacity_] = sample;
+    ++count_;
+
+    // Removal updates accumulate rounding error; rebuild from the window once
+    // per full turnover so the drift stays bounded (amortized O(1)).
+    if (evictions_ >= capacity_) {
+        resync();
     }
-    samples_.push_back(quote);
 }
 
-std::size_t StatsBuffer::size() const { return samples_.size(); }
+std::size_t StatsBuffer::size() const { return count_; }
 
-bool StatsBuffer::empty() const { return samples_.empty(); }
+bool StatsBuffer::empty() const { return count_ == 0; }
 
-double StatsBuffer::latestPrice() const { return samples_.empty() ? 0.0 : samples_.back().price; }
+double StatsBuffer::latestPrice() const { return count_ == 0 ? 0.0 : at(count_ - 1).price; }
 
-double StatsBuffer::latestSpread() const {
-    if (samples_.empty()) return 0.0;
-    const auto &q = samples_.back();
-    return q.ask - q.bid;
-}
+double StatsBuffer::latestSpread() const { return count_ == 0 ? 0.0 : at(count_ - 1).spread; }
 
 double StatsBuffer::priceReturn() const {
-    if (samples_.size() < 2) return 0.0;
-    const auto &last = samples_.back();
-    const auto &prev = samples_[samples_.size() - 2];
+    if (count_ < 2) return 0.0;
+    const auto &last = at(count_ - 1);
+    const auto &prev = at(count_ - 2);
     if (prev.price == 0.0) return 0.0;
     return (last.price - prev.price) / prev.price;
 }
 
 double StatsBuffer::recentVolatility() const {
-    auto returns = computeReturns();
-    if (returns.size() < 2) return 0.0;
-    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    double accum = 0.0;
-    for (double r : returns) {
-        double diff = r - mean;
-        accum += diff * diff;
-    }
-    return std::sqrt(accum / returns.size());
+    if (count_ < 3) return 0.0;
+    double variance = return_m2_ / static_cast<double>(count_ - 1);
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
 }
 
 double StatsBuffer::meanSpread() const {
-    if (samples_.empty()) return 0.0;
-    double sum = 0.0;
-    for (const auto &q : samples_) {
-        sum += (q.ask - q.bid);
+    if (count_ == 0) return 0.0;
+    return spread_sum_ / static_cast<double>(count_);
+}
+
+double StatsBuffer::shortTermSlope() const { return slopeOver(10); }
+
+double StatsBuffer::longTermSlope() const { return slopeOver(60); }
+
+StatsBuffer::Aggregates StatsBuffer::aggregates() const {
+    return Aggregates{return_mean_, return_m2_, spread_sum_, evictions_};
+}
+
+void StatsBuffer::copyWindow(std::span<Sample> out) const {
+    for (std::size_t i = 0; i < count_ && i < out.size(); ++i) {
+        out[i] = at(i);
     }
-    return sum / static_cast<double>(samples_.size());
 }
 
-double StatsBuffer::shortTermSlope() const {
-    if (samples_.size() < 2) return 0.0;
-    std::size_t window = std::min<std::size_t>(10, samples_.size());
-    const auto &first = samples_[samples_.size() - window];
-    const auto &last = samples_.back();
-    return (last.price - first.price) / static_cast<double>(window);
+void StatsBuffer::restore(std::span<const Sample> window, const Aggregates &aggregates) {
+    count_ = std::min(window.size(), capacity_);
+    head_ = 0;
+    std::copy_n(window.begin(), count_, ring_.begin());
+    // Running values are rebuilt from the window rather than trusted; only
+    // the position in the resync cycle is carried over.
+    resync();
+    evictions_ = static_cast<std::size_t>(aggregates.evictions);
 }
 
-double StatsBuffer::longTermSlope() const {
-    if (samples_.size() < 2) return 0.0;
-    std::size_t window = std::min<std::size_t>(60, samples_.size());
-    const auto &first = samples_[samples_.size() - window];
-    const auto &last = samples_.back();
+const StatsBuffer::Sample &StatsBuffer::at(std::size_t index) const { return ring_[(head_ + index) % capacity_]; }
+
+double StatsBuffer::slopeOver(std::size_t window) const {
+    if (count_ < 2) return 0.0;
+    window = std::min(window, count_);
+    const auto &first = at(count_ - window);
+    const auto &last = at(count_ - 1);
     return (last.price - first.price) / static_cast<double>(window);
 }
 
-std::vector<double> StatsBuffer::computeReturns() const {
-    std::vector<double> returns;
-    if (samples_.size() < 2) return returns;
-    returns.reserve(samples_.size() - 1);
-    for (std::size_t i = 1; i < samples_.size(); ++i) {
-        double prev = samples_[i - 1].price;
-        if (prev == 0.0) {
-            returns.push_back(0.0);
-        } else {
-            returns.push_back((samples_[i].price - prev) / prev);
-        }
+double StatsBuffer::returnBetween(const Sample &prev, const Sample &next) {
+    if (prev.price == 0.0) return 0.0;
+    return (next.price - prev.price) / prev.price;
+}
+
+void StatsBuffer::pushReturn(double value) {
+    // Returns in the window before this push: count_ - 1 (count_ >= 1 here).
+    double n = static_cast<double>(count_);
+    double delta = value - return_mean_;
+    return_mean_ += delta / n;
+    return_m2_ += delta * (value - return_mean_);
+}
+
+void StatsBuffer::popReturn(double value) {
+    // Returns in the window before this pop: count_ - 1 (count_ >= 2 here).
+    std::size_t remaining = count_ - 2;
+    if (remaining == 0) {
+        return_mean_ = 0.0;
+        return_m2_ = 0.0;
+        return;
     }
-    return returns;
+    double old_mean = return_mean_;
+    return_mean_ = old_mean - (value - old_mean) / static_cast<double>(remaining);
+    return_m2_ = std::max(0.0, return_m2_ - (value - old_mean) * (value - return_mean_));
 }
 
+void StatsBuffer::resync() {
+    evictions_ = 0;
+    spread_sum_ = 0.0;
+    return_mean_ = 0.0;
+    return_m2_ = 0.0;
+    if (count_ == 0) return;
+
+    // Walks the ring by index rather than through at(), which would cost a
+    // division per sample; restore() runs this for every ticker.
+    auto next = [this](std::size_t index) { return index + 1 == capacity_ ? 0 : index + 1; };
+    std::size_t index = head_;
+    double sum = 0.0;
+    spread_sum_ = ring_[index].spread;
+    for (std::size_t i = 1; i < count_; ++i) {
+        std::size_t following = next(index);
+        spread_sum_ += ring_[following].spread;
+        sum += returnBetween(ring_[index], ring_[following]);
+        index = following;
+    }
+    if (count_ < 2) return;
+    return_mean_ = sum / static_cast<double>(count_ - 1);
+    index = head_;
+    for (std::size_t i = 1; i < count_; ++i) {
+        std::size_t following = next(index);
+        double diff = returnBetween(ring_[index], ring_[following]) - return_mean_;
+        return_m2_ += diff * diff;
+        index = following;
+    }
+}
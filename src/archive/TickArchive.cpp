@@ -0,0 +1,391 @@
+#include "quantis/archive/TickArchive.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace tick_archive;
+
+namespace {
+constexpr std::size_t padded(std::size_t bytes) { return (bytes + 7) & ~std::size_t{7}; }
+
+template <typename T>
+void appendColumn(std::vector<char> &out, const std::vector<T> &column) {
+    std::size_t bytes = column.size() * sizeof(T);
+    std::size_t offset = out.size();
+    out.resize(offset + padded(bytes), 0);
+    if (bytes > 0) {
+        std::memcpy(out.data() + offset, column.data(), bytes);
+    }
+}
+
+template <typename T>
+std::span<const T> readColumn(const char *&cursor, std::size_t rows) {
+    std::span<const T> column(reinterpret_cast<const T *>(cursor), rows);
+    cursor += padded(rows * sizeof(T));
+    return column;
+}
+
+constexpr TickerId kUnassigned = static_cast<TickerId>(-1);
+
+// Bytes a Ticks block of `rows` rows takes, or 0 if that would overflow.
+std::size_t ticksPayloadBytes(std::uint64_t rows) {
+    constexpr std::size_t kWideColumns = 10;
+    if (rows > SIZE_MAX / (kWideColumns * 8 + sizeof(TickerId) + 8)) return 0;
+    return kWideColumns * padded(rows * 8) + padded(rows * sizeof(TickerId));
+}
+
+std::runtime_error systemError(const std::string &what, const std::string &path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+}
+
+TickBlockView TickBlockView::slice(std::size_t begin, std::size_t end) const {
+    std::size_t count = end - begin;
+    TickBlockView view;
+    view.timestamp = timestamp.subspan(begin, count);
+    view.ticker = ticker.subspan(begin, count);
+    view.price = price.subspan(begin, count);
+    view.market_cap = market_cap.subspan(begin, count);
+    view.daily_percent_change = daily_percent_change.subspan(begin, count);
+    view.volume = volume.subspan(begin, count);
+    view.average_volume = average_volume.subspan(begin, count);
+    view.fiftytwo_week_high = fiftytwo_week_high.subspan(begin, count);
+    view.fiftytwo_week_low = fiftytwo_week_low.subspan(begin, count);
+    view.bid = bid.subspan(begin, count);
+    view.ask = ask.subspan(begin, count);
+    return view;
+}
+
+Quote TickBlockView::quote(std::size_t row) const {
+    Quote q;
+    q.price = price[row];
+    q.market_cap = market_cap[row];
+    q.daily_percent_change = daily_percent_change[row];
+    q.volume = volume[row];
+    q.average_volume = average_volume[row];
+    q.fiftytwo_week_high = fiftytwo_week_high[row];
+    q.fiftytwo_week_low = fiftytwo_week_low[row];
+    q.bid = bid[row];
+    q.ask = ask[row];
+    return q;
+}
+
+void TickArchiveWriter::Block::reserve(std::size_t rows) {
+    timestamp.reserve(rows);
+    ticker.reserve(rows);
+    for (auto *column : {&price, &market_cap, &daily_percent_change, &fiftytwo_week_high, &fiftytwo_week_low, &bid, &ask}) {
+        column->reserve(rows);
+    }
+    volume.reserve(rows);
+    average_volume.reserve(rows);
+}
+
+TickArchiveWriter::TickArchiveWriter(const std::string &path, std::size_t block_rows)
+    : path_(path), block_rows_(std::max<std::size_t>(block_rows, 1)) {
+    // Picks up the symbols an earlier session assigned ids to, so its rows
+    // and ours name tickers the same way, and where its timestamps ended.
+    std::size_t append_at = 0;
+    struct stat st {};
+    if (::stat(path.c_str(), &st) == 0 && st.st_size > 0) {
+        TickArchiveReader existing(path);
+        for (std::size_t id = 0; id < existing.symbolCount(); ++id) {
+            symbol_ids_.emplace(existing.symbol(static_cast<TickerId>(id)), static_cast<TickerId>(id));
+        }
+        append_at = existing.validBytes();
+        if (!existing.blocks().empty() && existing.blocks().back().size() > 0) {
+            last_timestamp_ = existing.blocks().back().timestamp.back();
+        }
+    }
+
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw systemError("Unable to open archive", path);
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(append_at)) != 0 ||
+        ::lseek(fd_, static_cast<off_t>(append_at), SEEK_SET) < 0) {
+        int saved = errno;
+        ::close(fd_);
+        errno = saved;
+        throw systemError("Unable to append to archive", path);
+    }
+    if (append_at == 0) {
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        try {
+            writeAll(&header, sizeof(header));
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    current_.reserve(block_rows_);
+    writer_ = std::thread([this] { writerLoop(); });
+}
+
+TickArchiveWriter::~TickArchiveWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    writer_.join();
+    ::close(fd_);
+}
+
+void TickArchiveWriter::append(std::int64_t timestamp_ns, TickerId id, std::string_view symbol, const Quote &quote) {
+    if (id >= archive_ids_.size()) {
+        archive_ids_.resize(static_cast<std::size_t>(id) + 1, kUnassigned);
+    }
+    if (archive_ids_[id] == kUnassigned) {
+        auto [it, added] = symbol_ids_.emplace(symbol, static_cast<TickerId>(symbol_ids_.size()));
+        if (added) {
+            current_.symbols.emplace_back(it->second, it->first);
+        }
+        archive_ids_[id] = it->second;
+    }
+
+    // range() binary-searches timestamps, so they must never decrease.
+    last_timestamp_ = std::max(last_timestamp_, timestamp_ns);
+    current_.timestamp.push_back(last_timestamp_);
+    current_.ticker.push_back(archive_ids_[id]);
+    current_.price.push_back(quote.price);
+    current_.market_cap.push_back(quote.market_cap);
+    current_.daily_percent_change.push_back(quote.daily_percent_change);
+    current_.volume.push_back(quote.volume);
+    current_.average_volume.push_back(quote.average_volume);
+    current_.fiftytwo_week_high.push_back(quote.fiftytwo_week_high);
+    current_.fiftytwo_week_low.push_back(quote.fiftytwo_week_low);
+    current_.bid.push_back(quote.bid);
+    current_.ask.push_back(quote.ask);
+
+    if (current_.timestamp.size() >= block_rows_) {
+        flush();
+    }
+}
+
+void TickArchiveWriter::flush() {
+    if (current_.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sealed_.push_back(std::move(current_));
+    }
+    cv_.notify_one();
+    current_ = Block{};
+    current_.reserve(block_rows_);
+}
+
+void TickArchiveWriter::writerLoop() {
+    while (true) {
+        Block block;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !sealed_.empty(); });
+            if (sealed_.empty()) return;
+            block = std::move(sealed_.front());
+            sealed_.pop_front();
+        }
+        if (failed_) continue;
+        try {
+            writeBlock(block);
+        } catch (const std::exception &ex) {
+            // Recording is best-effort; never take the realtime loop down.
+            std::cerr << "Tick recording stopped: " << ex.what() << "\n";
+            failed_ = true;
+        }
+    }
+}
+
+void TickArchiveWriter::writeBlock(const Block &block) {
+    if (!block.symbols.empty()) {
+        scratch_.clear();
+        for (const auto &[id, symbol] : block.symbols) {
+            std::uint32_t entry[2] = {id, static_cast<std::uint32_t>(symbol.size())};
+            std::size_t offset = scratch_.size();
+            scratch_.resize(offset + padded(sizeof(entry) + symbol.size()), 0);
+            std::memcpy(scratch_.data() + offset, entry, sizeof(entry));
+            std::memcpy(scratch_.data() + offset + sizeof(entry), symbol.data(), symbol.size());
+        }
+        BlockHeader header{};
+        header.kind = BlockKind::Symbols;
+        header.payload_bytes = scratch_.size();
+        header.rows = block.symbols.size();
+        writeAll(&header, sizeof(header));
+        writeAll(scratch_.data(), scratch_.size());
+    }
+
+    if (block.timestamp.empty()) return;
+
+    scratch_.clear();
+    appendColumn(scratch_, block.timestamp);
+    appendColumn(scratch_, block.ticker);
+    appendColumn(scratch_, block.price);
+    appendColumn(scratch_, block.market_cap);
+    appendColumn(scratch_, block.daily_percent_change);
+    appendColumn(scratch_, block.volume);
+    appendColumn(scratch_, block.average_volume);
+    appendColumn(scratch_, block.fiftytwo_week_high);
+    appendColumn(scratch_, block.fiftytwo_week_low);
+    appendColumn(scratch_, block.bid);
+    appendColumn(scratch_, block.ask);
+
+    BlockHeader header{};
+    header.kind = BlockKind::Ticks;
+    header.payload_bytes = scratch_.size();
+    header.rows = block.timestamp.size();
+    header.first_timestamp = block.timestamp.front();
+    header.last_timestamp = block.timestamp.back();
+    writeAll(&header, sizeof(header));
+    writeAll(scratch_.data(), scratch_.size());
+}
+
+void TickArchiveWriter::writeAll(const void *data, std::size_t size) {
+    const char *cursor = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd_, cursor, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("Failed writing archive", path_);
+        }
+        cursor += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+TickArchiveReader::TickArchiveReader(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw systemError("Unable to open archive", path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw systemError("Unable to stat archive", path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a tick archive: " + path);
+    }
+
+    void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw systemError("Unable to map archive", path);
+    }
+    data_ = static_cast<const char *>(mapped);
+    ::madvise(mapped, size_, MADV_SEQUENTIAL);
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        ::munmap(mapped, size_);
+        throw std::runtime_error("Not a tick archive (or unsupported version): " + path);
+    }
+    index();
+}
+
+TickArchiveReader::~TickArchiveReader() {
+    if (data_) {
+        ::munmap(const_cast<char *>(data_), size_);
+    }
+}
+
+// Indexing stops at the first block that does not fit its payload, such as
+// a trailing partial block after a crash mid-write or a damaged one; the
+// blocks before it stay readable.
+void TickArchiveReader::index() {
+    std::size_t offset = sizeof(FileHeader);
+    while (offset + sizeof(BlockHeader) <= size_) {
+        BlockHeader header;
+        std::memcpy(&header, data_ + offset, sizeof(header));
+        const char *payload = data_ + offset + sizeof(header);
+        if (header.payload_bytes > size_ - offset - sizeof(header)) break;
+        const char *payload_end = payload + header.payload_bytes;
+
+        if (header.kind == BlockKind::Symbols) {
+            // Ids are handed out in order, so each entry names a known
+            // ticker or the next new one.
+            const char *cursor = payload;
+            std::size_t known = symbols_.size();
+            bool valid = header.rows <= header.payload_bytes / sizeof(std::uint64_t);
+            for (std::uint64_t i = 0; valid && i < header.rows; ++i) {
+                std::uint32_t entry[2];
+                if (static_cast<std::size_t>(payload_end - cursor) < sizeof(entry)) {
+                    valid = false;
+                    break;
+                }
+                std::memcpy(entry, cursor, sizeof(entry));
+                std::size_t available = static_cast<std::size_t>(payload_end - cursor) - sizeof(entry);
+                if (entry[1] > available || entry[0] > symbols_.size()) {
+                    valid = false;
+                    break;
+                }
+                if (entry[0] == symbols_.size()) {
+                    symbols_.emplace_back();
+                }
+                symbols_[entry[0]] = std::string_view(cursor + sizeof(entry), entry[1]);
+                cursor += std::min(padded(sizeof(entry) + entry[1]), static_cast<std::size_t>(payload_end - cursor));
+            }
+            if (!valid) {
+                symbols_.resize(known);
+                break;
+            }
+        } else if (header.kind == BlockKind::Ticks) {
+            std::size_t rows = header.rows;
+            std::size_t bytes = ticksPayloadBytes(rows);
+            if ((bytes == 0 && rows != 0) || bytes > header.payload_bytes) break;
+            const char *cursor = payload;
+            TickBlockView view;
+            view.timestamp = readColumn<std::int64_t>(cursor, rows);
+            view.ticker = readColumn<TickerId>(cursor, rows);
+            view.price = readColumn<double>(cursor, rows);
+            view.market_cap = readColumn<double>(cursor, rows);
+            view.daily_percent_change = readColumn<double>(cursor, rows);
+            view.volume = readColumn<std::int64_t>(cursor, rows);
+            view.average_volume = readColumn<std::int64_t>(cursor, rows);
+            view.fiftytwo_week_high = readColumn<double>(cursor, rows);
+            view.fiftytwo_week_low = readColumn<double>(cursor, rows);
+            view.bid = readColumn<double>(cursor, rows);
+            view.ask = readColumn<double>(cursor, rows);
+            blocks_.push_back(view);
+            rows_ += rows;
+        }
+        offset += sizeof(header) + header.payload_bytes;
+    }
+    valid_bytes_ = offset;
+}
+
+const std::vector<TickBlockView> &TickArchiveReader::blocks() const { return blocks_; }
+
+std::size_t TickArchiveReader::rows() const { return rows_; }
+
+std::size_t TickArchiveReader::symbolCount() const { return symbols_.size(); }
+
+std::size_t TickArchiveReader::validBytes() const { return valid_bytes_; }
+
+std::string_view TickArchiveReader::symbol(TickerId id) const {
+    return id < symbols_.size() ? symbols_[id] : std::string_view{};
+}
+
+std::vector<TickBlockView> TickArchiveReader::range(std::int64_t from_ns, std::int64_t to_ns) const {
+    std::vector<TickBlockView> views;
+    for (const auto &block : blocks_) {
+        if (block.size() == 0 || block.timestamp.back() < from_ns || block.timestamp.front() >= to_ns) continue;
+        auto begin = std::lower_bound(block.timestamp.begin(), block.timestamp.end(), from_ns);
+        auto end = std::lower_bound(begin, block.timestamp.end(), to_ns);
+        if (begin == end) continue;
+        views.push_back(block.slice(static_cast<std::size_t>(begin - block.timestamp.begin()),
+                                    static_cast<std::size_t>(end - block.timestamp.begin())));
+    }
+    return views;
+}
@@ -0,0 +1,38 @@
+#include "quantis/daemon/DaemonClient.hpp"
+#include "quantis/feed/FeedProtocol.hpp"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+// The daemon answers from memory; this only bounds a wedged daemon.
+constexpr timeval kReplyTimeout{10, 0};
+}
+
+std::optional<daemon_protocol::Reply> callDaemon(const std::string &path, const daemon_protocol::Request &request) {
+    FeedEndpoint endpoint;
+    try {
+        endpoint = FeedEndpoint::parse("unix:" + path);
+    } catch (const std::invalid_argument &) {
+        return std::nullopt;
+    }
+    // Unix sockets connect or fail straight away, even non-blocking.
+    int fd = connectFeed(endpoint);
+    if (fd < 0) return std::nullopt;
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &kReplyTimeout, sizeof(kReplyTimeout));
+
+    std::string message;
+    daemon_protocol::appendRequest(message, request);
+    daemon_protocol::Reply reply;
+    bool ok = daemon_protocol::writeMessage(fd, message) &&
+              daemon_protocol::readMessage(fd, message, daemon_protocol::kMaxReplySize) &&
+              daemon_protocol::parseReply(message, reply);
+    ::close(fd);
+    if (!ok) {
+        reply = daemon_protocol::Reply{1, "", "No answer from the quantis daemon on " + path + "\n"};
+    }
+    return reply;
+}
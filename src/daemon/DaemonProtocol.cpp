@@ -0,0 +1,130 @@
+#include "quantis/daemon/DaemonProtocol.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace daemon_protocol {
+
+namespace {
+constexpr std::size_t kRequestFixedSize = sizeof(MessageHeader) + 20;
+constexpr std::size_t kReplyFixedSize = sizeof(MessageHeader) + 12;
+
+template <typename T>
+void append(std::string &out, T value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+T load(const char *data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void appendHeader(std::string &out, MessageType type, std::size_t length) {
+    append(out, MessageHeader{kMagic, kVersion, type, static_cast<std::uint32_t>(length)});
+}
+
+bool checkHeader(std::span<const char> message, MessageType type, std::size_t fixed_size) {
+    if (message.size() < fixed_size) return false;
+    auto header = load<MessageHeader>(message.data());
+    return header.magic == kMagic && header.version == kVersion && header.type == type &&
+           header.length == message.size();
+}
+}
+
+void appendRequest(std::string &out, const Request &request) {
+    appendHeader(out, MessageType::Request, kRequestFixedSize + request.symbol.size() + request.where.size());
+    append(out, static_cast<std::uint8_t>(request.command));
+    append(out, static_cast<std::uint8_t>(request.sort));
+    append(out, std::uint16_t{0});
+    append(out, request.top);
+    append(out, request.page);
+    append(out, static_cast<std::uint32_t>(request.symbol.size()));
+    append(out, static_cast<std::uint32_t>(request.where.size()));
+    out += request.symbol;
+    out += request.where;
+}
+
+void appendReply(std::string &out, const Reply &reply) {
+    appendHeader(out, MessageType::Reply, kReplyFixedSize + reply.out.size() + reply.err.size());
+    append(out, reply.status);
+    append(out, static_cast<std::uint32_t>(reply.out.size()));
+    append(out, static_cast<std::uint32_t>(reply.err.size()));
+    out += reply.out;
+    out += reply.err;
+}
+
+bool parseRequest(std::span<const char> message, Request &request) {
+    if (!checkHeader(message, MessageType::Request, kRequestFixedSize)) return false;
+    const char *body = message.data() + sizeof(MessageHeader);
+    auto command = load<std::uint8_t>(body);
+    auto sort = load<std::uint8_t>(body + 1);
+    auto symbol_size = load<std::uint32_t>(body + 12);
+    auto where_size = load<std::uint32_t>(body + 16);
+    if (command < static_cast<std::uint8_t>(Command::List) || command > static_cast<std::uint8_t>(Command::Export) ||
+        sort > static_cast<std::uint8_t>(SortKey::Alerts) ||
+        std::size_t{symbol_size} + where_size != message.size() - kRequestFixedSize) {
+        return false;
+    }
+    request.command = static_cast<Command>(command);
+    request.sort = static_cast<SortKey>(sort);
+    request.top = load<std::uint32_t>(body + 4);
+    request.page = load<std::uint32_t>(body + 8);
+    const char *text = message.data() + kRequestFixedSize;
+    request.symbol.assign(text, symbol_size);
+    request.where.assign(text + symbol_size, where_size);
+    return true;
+}
+
+bool parseReply(std::span<const char> message, Reply &reply) {
+    if (!checkHeader(message, MessageType::Reply, kReplyFixedSize)) return false;
+    const char *body = message.data() + sizeof(MessageHeader);
+    auto out_size = load<std::uint32_t>(body + 4);
+    auto err_size = load<std::uint32_t>(body + 8);
+    if (std::size_t{out_size} + err_size != message.size() - kReplyFixedSize) return false;
+    reply.status = load<std::int32_t>(body);
+    const char *text = message.data() + kReplyFixedSize;
+    reply.out.assign(text, out_size);
+    reply.err.assign(text + out_size, err_size);
+    return true;
+}
+
+bool readMessage(int fd, std::string &message, std::size_t max_size) {
+    auto readExactly = [fd](char *data, std::size_t size) {
+        while (size > 0) {
+            ssize_t received = ::recv(fd, data, size, 0);
+            if (received < 0 && errno == EINTR) continue;
+            if (received <= 0) return false;
+            data += received;
+            size -= static_cast<std::size_t>(received);
+        }
+        return true;
+    };
+
+    message.resize(sizeof(MessageHeader));
+    if (!readExactly(message.data(), message.size())) return false;
+    auto header = load<MessageHeader>(message.data());
+    if (header.magic != kMagic || header.version != kVersion || header.length < sizeof(MessageHeader) ||
+        header.length > max_size) {
+        return false;
+    }
+    message.resize(header.length);
+    return readExactly(message.data() + sizeof(MessageHeader), header.length - sizeof(MessageHeader));
+}
+
+bool writeMessage(int fd, const std::string &message) {
+    std::string_view data(message);
+    while (!data.empty()) {
+        ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(sent));
+    }
+    return true;
+}
+
+} // namespace daemon_protocol
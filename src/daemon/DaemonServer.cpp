@@ -0,0 +1,79 @@
+#include "quantis/daemon/DaemonServer.hpp"
+#include "quantis/feed/FeedProtocol.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+constexpr timeval kRequestTimeout{0, 200000};
+// Replies can be whole CSV exports; give a slow reader more time.
+constexpr timeval kReplyTimeout{5, 0};
+}
+
+DaemonServer::DaemonServer(std::string path) : path_(std::move(path)) {
+    FeedEndpoint endpoint;
+    try {
+        endpoint = FeedEndpoint::parse("unix:" + path_);
+    } catch (const std::invalid_argument &ex) {
+        throw std::runtime_error(ex.what());
+    }
+    // listenFeed unlinks whatever is at the path, so make sure it is not a
+    // running daemon first.
+    int probe = connectFeed(endpoint);
+    if (probe >= 0) {
+        ::close(probe);
+        throw std::runtime_error("A quantis daemon is already running on " + path_);
+    }
+    listen_fd_ = listenFeed(endpoint);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("Cannot listen on " + path_ + ": " + std::strerror(errno));
+    }
+}
+
+DaemonServer::~DaemonServer() {
+    ::close(listen_fd_);
+    ::unlink(path_.c_str());
+}
+
+std::size_t DaemonServer::serveUntil(std::chrono::steady_clock::time_point deadline, const Handler &handler) {
+    std::size_t answered = 0;
+    while (true) {
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) return answered;
+        pollfd listener{listen_fd_, POLLIN, 0};
+        int ready = ::poll(&listener, 1, static_cast<int>(std::min<std::int64_t>(left.count(), 1000)));
+        if (ready < 0) {
+            if (errno == EINTR) return answered;
+            throw std::runtime_error(std::string("Daemon event loop failed: ") + std::strerror(errno));
+        }
+        while (ready > 0) {
+            int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) break;
+            answer(fd, handler);
+            ::close(fd);
+            ++answered;
+        }
+    }
+}
+
+void DaemonServer::answer(int fd, const Handler &handler) {
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &kRequestTimeout, sizeof(kRequestTimeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &kReplyTimeout, sizeof(kReplyTimeout));
+    if (!daemon_protocol::readMessage(fd, message_, daemon_protocol::kMaxRequestSize)) return;
+
+    reply_ = daemon_protocol::Reply{};
+    if (daemon_protocol::parseRequest(message_, request_)) {
+        handler(request_, reply_);
+    } else {
+        reply_.status = 1;
+        reply_.err = "Malformed request\n";
+    }
+    message_.clear();
+    daemon_protocol::appendReply(message_, reply_);
+    daemon_protocol::writeMessage(fd, message_);
+}
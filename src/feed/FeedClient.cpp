@@ -0,0 +1,321 @@
+#include "quantis/feed/FeedClient.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::size_t kReadBuffer = 256 * 1024;
+constexpr std::chrono::milliseconds kFirstBackoff{100};
+constexpr std::chrono::milliseconds kMaxBackoff{5000};
+// How long beginTick waits for newly subscribed tickers' first quotes.
+constexpr std::chrono::milliseconds kSnapshotWait{2000};
+constexpr int kMaxEvents = 8;
+}
+
+FeedClient::FeedClient(const SymbolTable &symbols, FeedEndpoint endpoint)
+    : symbols_(symbols), endpoint_(std::move(endpoint)), input_(kReadBuffer) {
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wake_fd_;
+    if (epoll_fd_ < 0 || wake_fd_ < 0 || ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) != 0) {
+        std::string error = std::strerror(errno);
+        if (epoll_fd_ >= 0) ::close(epoll_fd_);
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        throw std::runtime_error("Cannot start quote feed client: " + error);
+    }
+    thread_ = std::thread([this] { run(); });
+}
+
+FeedClient::~FeedClient() {
+    running_.store(false);
+    wake();
+    thread_.join();
+    disconnect();
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+}
+
+void FeedClient::beginTick(std::span<const TickerId> ids) {
+    {
+        std::lock_guard lock(subscription_mutex_);
+        if (std::equal(ids.begin(), ids.end(), subscription_ids_.begin(), subscription_ids_.end())) return;
+    }
+
+    std::string subscription;
+    feed_protocol::appendReset(subscription);
+    for (TickerId id : ids) {
+        feed_protocol::appendSubscribe(subscription, id, symbols_.symbol(id));
+    }
+
+    std::unique_lock cache_lock(cache_mutex_);
+    TickerId max_id = ids.empty() ? 0 : *std::max_element(ids.begin(), ids.end());
+    if (!ids.empty() && max_id >= cache_.size()) {
+        cache_.resize(static_cast<std::size_t>(max_id) + 1);
+        has_quote_.resize(cache_.size(), 0);
+        subscribed_.resize(cache_.size(), 0);
+    }
+    // Updates for unsubscribed ids are dropped, so a cached quote of a
+    // ticker coming back may be stale; wait for its snapshot again.
+    for (TickerId id : ids) {
+        if (!subscribed_[id]) has_quote_[id] = 0;
+    }
+    std::fill(subscribed_.begin(), subscribed_.end(), 0);
+    missing_ = 0;
+    for (TickerId id : ids) {
+        subscribed_[id] = 1;
+        missing_ += has_quote_[id] ? 0 : 1;
+    }
+
+    {
+        std::lock_guard lock(subscription_mutex_);
+        subscription_ids_.assign(ids.begin(), ids.end());
+        subscription_ = std::move(subscription);
+        ++subscription_version_;
+    }
+    wake();
+    cache_cv_.wait_for(cache_lock, kSnapshotWait, [this] { return missing_ == 0; });
+}
+
+void FeedClient::getQuotes(std::span<const TickerId> ids, std::span<Quote> quotes) {
+    std::shared_lock lock(cache_mutex_);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        quotes[i] = ids[i] < cache_.size() ? cache_[ids[i]] : Quote{};
+    }
+}
+
+FeedClient::Stats FeedClient::stats() const {
+    return Stats{updates_.load(), missed_.load(), connects_.load(), connected_.load()};
+}
+
+void FeedClient::wake() {
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto written = ::write(wake_fd_, &one, sizeof(one));
+}
+
+void FeedClient::run() {
+    epoll_event events[kMaxEvents];
+    while (running_.load()) {
+        int timeout = -1;
+        if (socket_fd_ < 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= retry_at_) {
+                connect();
+                continue;
+            }
+            timeout = static_cast<int>(
+                std::chrono::ceil<std::chrono::milliseconds>(retry_at_ - now).count());
+        }
+
+        int ready = ::epoll_wait(epoll_fd_, events, kMaxEvents, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Quote feed event loop failed: " << std::strerror(errno) << "\n";
+            return;
+        }
+        for (int i = 0; i < ready; ++i) {
+            if (events[i].data.fd == wake_fd_) {
+                std::uint64_t count = 0;
+                [[maybe_unused]] auto drained = ::read(wake_fd_, &count, sizeof(count));
+                queueSubscription();
+                continue;
+            }
+            if (socket_fd_ < 0) continue;
+
+            std::uint32_t flags = events[i].events;
+            if (connecting_) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                ::getsockopt(socket_fd_, SOL_SOCKET, SO_ERROR, &error, &length);
+                if (error != 0) {
+                    fail("connect", error);
+                    continue;
+                }
+                if (!(flags & EPOLLOUT)) continue;
+                connecting_ = false;
+                connected_.store(true);
+                connects_.fetch_add(1);
+                if (reported_down_) {
+                    std::cerr << "Quote feed " << endpoint_.text() << " connected.\n";
+                    reported_down_ = false;
+                }
+                backoff_ = std::chrono::milliseconds{0};
+                // A new connection starts with no subscriptions.
+                sent_version_ = static_cast<std::uint64_t>(-1);
+                queueSubscription();
+                if (socket_fd_ < 0) continue;
+            }
+            if ((flags & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !readUpdates()) {
+                fail("read", errno);
+                continue;
+            }
+            if ((flags & EPOLLOUT) && !flushOutput()) {
+                fail("write", errno);
+            }
+        }
+    }
+}
+
+void FeedClient::connect() {
+    int fd = connectFeed(endpoint_);
+    if (fd < 0) {
+        fail("connect", errno);
+        return;
+    }
+    socket_fd_ = fd;
+    connecting_ = true;
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT;
+    event.data.fd = socket_fd_;
+    want_write_ = true;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, socket_fd_, &event) != 0) {
+        fail("connect", errno);
+    }
+}
+
+// Drops the connection and schedules a reconnect with exponential backoff.
+// Only the first failure of an outage is reported.
+void FeedClient::fail(const char *operation, int error) {
+    bool was_connected = connected_.load();
+    disconnect();
+    if (!running_.load()) return;
+    if (!reported_down_) {
+        std::cerr << "Quote feed " << endpoint_.text()
+                  << (was_connected ? " disconnected" : std::string(" unavailable (") + operation + ": " +
+                                                            std::strerror(error) + ")")
+                  << "; reconnecting in the background.\n";
+        reported_down_ = true;
+    }
+    backoff_ = backoff_.count() == 0 ? kFirstBackoff : std::min(backoff_ * 2, kMaxBackoff);
+    retry_at_ = std::chrono::steady_clock::now() + backoff_;
+}
+
+void FeedClient::disconnect() {
+    if (socket_fd_ >= 0) {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, socket_fd_, nullptr);
+        ::close(socket_fd_);
+        socket_fd_ = -1;
+    }
+    connecting_ = false;
+    want_write_ = false;
+    connected_.store(false);
+    output_.clear();
+    output_sent_ = 0;
+    input_size_ = 0;
+    last_sequence_ = 0;
+}
+
+// Sends the latest subscription if this connection has not seen it yet.
+void FeedClient::queueSubscription() {
+    if (socket_fd_ < 0 || connecting_) return;
+    {
+        std::lock_guard lock(subscription_mutex_);
+        if (sent_version_ == subscription_version_) return;
+        output_.append(subscription_);
+        sent_version_ = subscription_version_;
+    }
+    if (!flushOutput()) {
+        fail("write", errno);
+    }
+}
+
+bool FeedClient::flushOutput() {
+    while (output_sent_ < output_.size()) {
+        ssize_t sent = ::send(socket_fd_, output_.data() + output_sent_, output_.size() - output_sent_, MSG_NOSIGNAL);
+        if (sent > 0) {
+            output_sent_ += static_cast<std::size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (output_sent_ == output_.size()) {
+        output_.clear();
+        output_sent_ = 0;
+    }
+    updateInterest();
+    return true;
+}
+
+void FeedClient::updateInterest() {
+    bool want_write = connecting_ || !output_.empty();
+    if (want_write == want_write_) return;
+    epoll_event event{};
+    event.events = EPOLLIN | (want_write ? EPOLLOUT : 0u);
+    event.data.fd = socket_fd_;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, socket_fd_, &event);
+    want_write_ = want_write;
+}
+
+// Reads until the socket would block, decoding every complete message of
+// each read straight into the cache. Returns false on EOF or error; errno is
+// 0 for an orderly close.
+bool FeedClient::readUpdates() {
+    while (true) {
+        ssize_t received = ::read(socket_fd_, input_.data() + input_size_, input_.size() - input_size_);
+        if (received == 0) {
+            errno = 0;
+            return false;
+        }
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        input_size_ += static_cast<std::size_t>(received);
+
+        quote_message::DecodeResult result;
+        first_quotes_ = false;
+        {
+            std::unique_lock lock(cache_mutex_);
+            result = quote_message::decode(std::span<const char>(input_.data(), input_size_),
+                                           [this](quote_message::QuoteView update) { apply(update); });
+        }
+        updates_.fetch_add(result.messages);
+        if (first_quotes_) {
+            cache_cv_.notify_all();
+        }
+        if (result.malformed) {
+            errno = EPROTO;
+            return false;
+        }
+        // Keep the partial last message for the next read.
+        input_size_ -= result.consumed;
+        std::memmove(input_.data(), input_.data() + result.consumed, input_size_);
+        if (input_size_ == input_.size()) {
+            errno = EPROTO;
+            return false;
+        }
+    }
+}
+
+// Runs under the unique cache lock. beginTick() sizes the cache for every
+// subscribed id, so anything else is dropped rather than letting an id off
+// the wire decide how much to allocate.
+void FeedClient::apply(quote_message::QuoteView update) {
+    std::uint64_t sequence = update.sequence();
+    if (sequence > last_sequence_ + 1) {
+        missed_.fetch_add(sequence - last_sequence_ - 1, std::memory_order_relaxed);
+    }
+    last_sequence_ = sequence;
+
+    TickerId id = update.tickerId();
+    if (id >= cache_.size() || !subscribed_[id]) return;
+    cache_[id] = update.quote();
+    if (!has_quote_[id]) {
+        has_quote_[id] = 1;
+        if (missing_ > 0) {
+            --missing_;
+            first_quotes_ = true;
+        }
+    }
+}
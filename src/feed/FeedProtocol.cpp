@@ -0,0 +1,156 @@
+#include "quantis/feed/FeedProtocol.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+FeedEndpoint FeedEndpoint::parse(std::string_view text) {
+    FeedEndpoint endpoint;
+    if (text.rfind("unix:", 0) == 0) {
+        endpoint.kind = Kind::Unix;
+        endpoint.path = std::string(text.substr(5));
+        if (endpoint.path.empty() || endpoint.path.size() >= sizeof(sockaddr_un::sun_path)) {
+            throw std::invalid_argument("Invalid unix socket path in feed endpoint: " + std::string(text));
+        }
+        return endpoint;
+    }
+
+    std::string_view rest = text.rfind("tcp:", 0) == 0 ? text.substr(4) : text;
+    auto colon = rest.rfind(':');
+    unsigned port = 0;
+    const char *port_end = rest.data() + rest.size();
+    if (colon == std::string_view::npos || colon == 0 ||
+        std::from_chars(rest.data() + colon + 1, port_end, port).ptr != port_end || port == 0 || port > 65535 ||
+        colon + 1 == rest.size()) {
+        throw std::invalid_argument("Invalid feed endpoint (expected HOST:PORT or unix:PATH): " + std::string(text));
+    }
+    endpoint.host = std::string(rest.substr(0, colon));
+    if (endpoint.host == "localhost") {
+        endpoint.host = "127.0.0.1";
+    }
+    in_addr address{};
+    if (inet_pton(AF_INET, endpoint.host.c_str(), &address) != 1) {
+        throw std::invalid_argument("Feed host must be a numeric IPv4 address: " + endpoint.host);
+    }
+    endpoint.port = static_cast<std::uint16_t>(port);
+    return endpoint;
+}
+
+std::string FeedEndpoint::text() const {
+    return kind == Kind::Unix ? "unix:" + path : host + ":" + std::to_string(port);
+}
+
+namespace {
+// Fills `storage` with the endpoint's socket address and returns its length.
+socklen_t socketAddress(const FeedEndpoint &endpoint, sockaddr_storage &storage) {
+    std::memset(&storage, 0, sizeof(storage));
+    if (endpoint.kind == FeedEndpoint::Kind::Unix) {
+        auto *address = reinterpret_cast<sockaddr_un *>(&storage);
+        address->sun_family = AF_UNIX;
+        std::memcpy(address->sun_path, endpoint.path.c_str(), endpoint.path.size() + 1);
+        return sizeof(sockaddr_un);
+    }
+    auto *address = reinterpret_cast<sockaddr_in *>(&storage);
+    address->sin_family = AF_INET;
+    address->sin_port = htons(endpoint.port);
+    inet_pton(AF_INET, endpoint.host.c_str(), &address->sin_addr);
+    return sizeof(sockaddr_in);
+}
+
+int openSocket(const FeedEndpoint &endpoint) {
+    int domain = endpoint.kind == FeedEndpoint::Kind::Unix ? AF_UNIX : AF_INET;
+    int fd = ::socket(domain, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && domain == AF_INET) {
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+void closeKeepingErrno(int fd) {
+    int saved = errno;
+    ::close(fd);
+    errno = saved;
+}
+}
+
+int listenFeed(const FeedEndpoint &endpoint) {
+    int fd = openSocket(endpoint);
+    if (fd < 0) return -1;
+    if (endpoint.kind == FeedEndpoint::Kind::Unix) {
+        ::unlink(endpoint.path.c_str());
+    } else {
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    sockaddr_storage address;
+    socklen_t length = socketAddress(endpoint, address);
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&address), length) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+        closeKeepingErrno(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int connectFeed(const FeedEndpoint &endpoint) {
+    int fd = openSocket(endpoint);
+    if (fd < 0) return -1;
+    sockaddr_storage address;
+    socklen_t length = socketAddress(endpoint, address);
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), length) != 0 && errno != EINPROGRESS) {
+        closeKeepingErrno(fd);
+        return -1;
+    }
+    return fd;
+}
+
+namespace feed_protocol {
+
+namespace {
+template <typename T>
+void appendInteger(std::string &out, T value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.push_back(' ');
+    out.append(digits, result.ptr);
+}
+
+// Parses one space-prefixed field and advances `cursor` past it.
+template <typename T>
+bool takeField(const char *&cursor, const char *end, T &value) {
+    if (cursor == end || *cursor != ' ') return false;
+    auto result = std::from_chars(cursor + 1, end, value);
+    cursor = result.ptr;
+    return result.ec == std::errc();
+}
+}
+
+void appendReset(std::string &out) { out.append("RESET\n"); }
+
+void appendSubscribe(std::string &out, TickerId id, std::string_view symbol) {
+    out.append("SUB");
+    appendInteger(out, id);
+    out.push_back(' ');
+    out.append(symbol).push_back('\n');
+}
+
+Command parseCommand(std::string_view line, TickerId &id, std::string_view &symbol) {
+    if (line == "RESET") return Command::Reset;
+    if (line.rfind("SUB", 0) != 0) return Command::Invalid;
+    const char *cursor = line.data() + 3;
+    const char *end = line.data() + line.size();
+    if (!takeField(cursor, end, id) || cursor == end || *cursor != ' ' || cursor + 1 == end) {
+        return Command::Invalid;
+    }
+    symbol = std::string_view(cursor + 1, static_cast<std::size_t>(end - cursor - 1));
+    return Command::Subscribe;
+}
+
+} // namespace feed_protocol
@@ -0,0 +1,258 @@
+#include "quantis/feed/FeedServer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <numeric>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+constexpr int kPublishPeriodMs = 1;
+constexpr int kMaxEvents = 64;
+// Unsent bytes past which a slow client's updates are dropped.
+constexpr std::size_t kMaxBacklog = 4 * 1024 * 1024;
+constexpr std::size_t kMaxCommandLine = 4096;
+// Caps the catch-up burst after the loop stalls, in seconds of updates.
+constexpr double kMaxCatchUp = 0.1;
+
+std::int64_t unixNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+}
+
+FeedServer::FeedServer(Options options) : options_(std::move(options)), simulator_(options_.seed) {
+    listen_fd_ = listenFeed(options_.endpoint);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("Cannot listen on " + options_.endpoint.text() + ": " + std::strerror(errno));
+    }
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_fd_ < 0 || ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event) != 0) {
+        std::string error = std::strerror(errno);
+        ::close(listen_fd_);
+        if (epoll_fd_ >= 0) ::close(epoll_fd_);
+        throw std::runtime_error("Cannot start feed server: " + error);
+    }
+    simulator_.advance(0);
+}
+
+FeedServer::~FeedServer() {
+    for (auto &connection : connections_) {
+        close(*connection);
+    }
+    ::close(epoll_fd_);
+    ::close(listen_fd_);
+    if (options_.endpoint.kind == FeedEndpoint::Kind::Unix) {
+        ::unlink(options_.endpoint.path.c_str());
+    }
+}
+
+void FeedServer::run(const std::atomic_bool &running) {
+    epoll_event events[kMaxEvents];
+    auto last = std::chrono::steady_clock::now();
+    double budget = 0.0;
+    while (running.load()) {
+        int ready = ::epoll_wait(epoll_fd_, events, kMaxEvents, options_.rate > 0 ? kPublishPeriodMs : 0);
+        if (ready < 0 && errno != EINTR) {
+            throw std::runtime_error(std::string("Feed server event loop failed: ") + std::strerror(errno));
+        }
+        for (int i = 0; i < ready; ++i) {
+            auto *connection = static_cast<Connection *>(events[i].data.ptr);
+            if (!connection) {
+                accept();
+                continue;
+            }
+            if (connection->fd < 0) continue;
+            if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !readCommands(*connection)) {
+                close(*connection);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && !flush(*connection)) {
+                close(*connection);
+            }
+        }
+        std::erase_if(connections_, [](const auto &connection) { return connection->fd < 0; });
+        client_count_.store(connections_.size());
+
+        auto now = std::chrono::steady_clock::now();
+        std::size_t count = symbols_.size();
+        if (options_.rate > 0) {
+            budget += options_.rate * std::chrono::duration<double>(now - last).count();
+            budget = std::min(budget, options_.rate * kMaxCatchUp);
+            count = static_cast<std::size_t>(budget);
+            budget -= static_cast<double>(count);
+        }
+        last = now;
+        publish(count);
+    }
+}
+
+FeedServer::Stats FeedServer::stats() const {
+    return Stats{published_.load(), dropped_.load(), client_count_.load(), ticker_count_.load()};
+}
+
+void FeedServer::accept() {
+    while (true) {
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (options_.endpoint.kind == FeedEndpoint::Kind::Tcp) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = connection.get();
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+        connections_.push_back(std::move(connection));
+    }
+}
+
+void FeedServer::close(Connection &connection) {
+    if (connection.fd < 0) return;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connection.fd = -1;
+}
+
+bool FeedServer::readCommands(Connection &connection) {
+    char buffer[16 * 1024];
+    while (true) {
+        ssize_t received = ::read(connection.fd, buffer, sizeof(buffer));
+        if (received == 0) return false;
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        connection.input.append(buffer, static_cast<std::size_t>(received));
+    }
+
+    std::size_t start = 0;
+    for (std::size_t newline; (newline = connection.input.find('\n', start)) != std::string::npos; start = newline + 1) {
+        std::string_view line(connection.input.data() + start, newline - start);
+        TickerId client_id{};
+        std::string_view symbol;
+        switch (feed_protocol::parseCommand(line, client_id, symbol)) {
+        case feed_protocol::Command::Reset:
+            std::fill(connection.client_ids.begin(), connection.client_ids.end(), SymbolTable::kInvalidId);
+            break;
+        case feed_protocol::Command::Subscribe:
+            subscribe(connection, client_id, symbol);
+            break;
+        case feed_protocol::Command::Invalid:
+            return false;
+        }
+    }
+    connection.input.erase(0, start);
+    if (connection.input.size() > kMaxCommandLine) return false;
+    return flush(connection);
+}
+
+// Maps the symbol to the client's id and sends its latest quote right away,
+// so a new subscriber does not wait a full round for data.
+void FeedServer::subscribe(Connection &connection, TickerId client_id, std::string_view symbol) {
+    TickerId id = symbols_.intern(symbol);
+    simulator_.extend(symbols_.size());
+    ticker_count_.store(symbols_.size());
+    if (connection.client_ids.size() <= id) {
+        connection.client_ids.resize(static_cast<std::size_t>(id) + 1, SymbolTable::kInvalidId);
+    }
+    connection.client_ids[id] = client_id;
+
+    Quote quote;
+    simulator_.current(std::span<const TickerId>(&id, 1), std::span<Quote>(&quote, 1));
+    quote.timestamp_ns = unixNanos();
+    quote_message::appendQuote(connection.output, ++connection.sequence, client_id, quote);
+    published_.fetch_add(1);
+}
+
+bool FeedServer::flush(Connection &connection) {
+    while (connection.output_sent < connection.output.size()) {
+        ssize_t sent = ::send(connection.fd, connection.output.data() + connection.output_sent,
+                              connection.output.size() - connection.output_sent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.output_sent += static_cast<std::size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (connection.output_sent == connection.output.size()) {
+        connection.output.clear();
+        connection.output_sent = 0;
+    }
+
+    bool want_write = !connection.output.empty();
+    if (want_write != connection.want_write) {
+        epoll_event event{};
+        event.events = EPOLLIN | (want_write ? EPOLLOUT : 0u);
+        event.data.ptr = &connection;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.want_write = want_write;
+    }
+    return true;
+}
+
+// Steps the next `count` tickers of the round-robin and sends each update to
+// its subscribers. A round ends when the cursor wraps, which starts the next
+// simulator tick.
+void FeedServer::publish(std::size_t count) {
+    const std::size_t universe = symbols_.size();
+    if (universe == 0 || connections_.empty()) return;
+
+    while (count > 0) {
+        if (cursor_ == 0) {
+            simulator_.advance(universe);
+        }
+        std::size_t n = std::min<std::size_t>(count, universe - cursor_);
+        step_ids_.resize(n);
+        step_quotes_.resize(n);
+        std::iota(step_ids_.begin(), step_ids_.end(), cursor_);
+        simulator_.step(step_ids_, step_quotes_);
+        std::int64_t now = unixNanos();
+        for (auto &quote : step_quotes_) {
+            quote.timestamp_ns = now;
+        }
+
+        for (auto &connection : connections_) {
+            if (connection->fd < 0) continue;
+            const auto &client_ids = connection->client_ids;
+            std::size_t end = std::min<std::size_t>(client_ids.size(), cursor_ + n);
+            bool backlogged = connection->output.size() - connection->output_sent > kMaxBacklog;
+            std::uint64_t sent = 0;
+            for (std::size_t id = cursor_; id < end; ++id) {
+                TickerId client_id = client_ids[id];
+                if (client_id == SymbolTable::kInvalidId) continue;
+                ++sent;
+                ++connection->sequence;
+                if (!backlogged) {
+                    quote_message::appendQuote(connection->output, connection->sequence, client_id,
+                                               step_quotes_[id - cursor_]);
+                }
+            }
+            (backlogged ? dropped_ : published_).fetch_add(sent);
+            if (!flush(*connection)) {
+                close(*connection);
+            }
+        }
+
+        cursor_ = static_cast<TickerId>((cursor_ + n) % universe);
+        count -= n;
+    }
+}
@@ -0,0 +1,20 @@
+#include "quantis/feed/QuoteMessage.hpp"
+
+namespace quote_message {
+
+void encodeQuote(char *out, std::uint64_t sequence, TickerId id, const Quote &quote) {
+    const std::uint32_t reserved = 0;
+    std::memcpy(out, &kQuoteHeaderWord, sizeof(kQuoteHeaderWord));
+    std::memcpy(out + kSequenceOffset, &sequence, sizeof(sequence));
+    std::memcpy(out + kTickerOffset, &id, sizeof(id));
+    std::memcpy(out + kTickerOffset + sizeof(id), &reserved, sizeof(reserved));
+    std::memcpy(out + kQuoteOffset, &quote, sizeof(quote));
+}
+
+void appendQuote(std::string &out, std::uint64_t sequence, TickerId id, const Quote &quote) {
+    std::size_t offset = out.size();
+    out.resize(offset + kQuoteMessageSize);
+    encodeQuote(out.data() + offset, sequence, id, quote);
+}
+
+} // namespace quote_message
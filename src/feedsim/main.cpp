@@ -0,0 +1,85 @@
+#include "quantis/feed/FeedServer.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+std::atomic_bool g_running{true};
+
+void handleSignal(int) { g_running.store(false); }
+
+void printUsage() {
+    std::cout << "Usage: quantis_feedsim [options]\n"
+              << "  --listen ENDPOINT    HOST:PORT or unix:PATH to serve on (default 127.0.0.1:7878)\n"
+              << "  --rate N|max         simulated updates per second across all tickers (default 100000)\n"
+              << "  --seed N             simulator seed (default 1)\n";
+}
+}
+
+int main(int argc, char **argv) {
+    FeedServer::Options options;
+    options.endpoint = FeedEndpoint::parse("127.0.0.1:7878");
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--listen") {
+                options.endpoint = FeedEndpoint::parse(value);
+            } else if (arg == "--rate") {
+                options.rate = value == "max" ? 0.0 : std::stod(value);
+                if (options.rate <= 0 && value != "max") {
+                    throw std::invalid_argument("Invalid value for --rate: " + value);
+                }
+            } else if (arg == "--seed") {
+                options.seed = std::stoull(value);
+            } else {
+                throw std::invalid_argument("Unknown option: " + arg);
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    try {
+        FeedServer server(options);
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        std::cout << "Serving simulated quotes on " << options.endpoint.text() << " at "
+                  << (options.rate > 0 ? std::to_string(static_cast<long long>(options.rate)) : std::string("max"))
+                  << " updates/s. Ctrl+C to stop.\n";
+
+        std::thread reporter([&] {
+            auto previous = server.stats();
+            while (g_running.load()) {
+                for (int i = 0; i < 50 && g_running.load(); ++i) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+                auto current = server.stats();
+                std::cout << current.clients << " clients, " << current.tickers << " tickers, "
+                          << (current.published - previous.published) / 5 << " updates/s, "
+                          << current.dropped - previous.dropped << " dropped\n";
+                previous = current;
+            }
+        });
+        server.run(g_running);
+        reporter.join();
+    } catch (const std::exception &ex) {
+        std::cerr << "Fatal error: " << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
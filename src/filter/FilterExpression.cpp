@@ -0,0 +1,416 @@
+#include "quantis/filter/FilterExpression.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+// Rows evaluated per pass over the bytecode; keeps the working set of one
+// instruction in L1.
+constexpr std::size_t kBatch = 256;
+
+struct FieldName {
+    std::string_view name;
+    bool numeric;
+    std::uint8_t field;
+};
+
+constexpr FieldName kFieldNames[] = {
+    {"price", true, static_cast<std::uint8_t>(NumericField::Price)},
+    {"market_cap", true, static_cast<std::uint8_t>(NumericField::MarketCap)},
+    {"daily_percent_change", true, static_cast<std::uint8_t>(NumericField::DailyPercentChange)},
+    {"volume", true, static_cast<std::uint8_t>(NumericField::Volume)},
+    {"average_volume", true, static_cast<std::uint8_t>(NumericField::AverageVolume)},
+    {"fiftytwo_week_high", true, static_cast<std::uint8_t>(NumericField::FiftyTwoWeekHigh)},
+    {"fiftytwo_week_low", true, static_cast<std::uint8_t>(NumericField::FiftyTwoWeekLow)},
+    {"bid", true, static_cast<std::uint8_t>(NumericField::Bid)},
+    {"ask", true, static_cast<std::uint8_t>(NumericField::Ask)},
+    {"ticker", false, static_cast<std::uint8_t>(TextField::Ticker)},
+    {"name", false, static_cast<std::uint8_t>(TextField::Name)},
+    {"sector", false, static_cast<std::uint8_t>(TextField::Sector)},
+    {"industry", false, static_cast<std::uint8_t>(TextField::Industry)},
+    {"notes", false, static_cast<std::uint8_t>(TextField::Notes)},
+    {"date_added", false, static_cast<std::uint8_t>(TextField::DateAdded)},
+};
+
+// Element-wise kernels over one batch.
+template <typename Fn>
+void applyUnary(const double *a, double *out, std::size_t len, Fn fn) {
+    for (std::size_t i = 0; i < len; ++i) out[i] = fn(a[i]);
+}
+
+template <typename Fn>
+void applyBinary(const double *a, const double *b, double *out, std::size_t len, Fn fn) {
+    for (std::size_t i = 0; i < len; ++i) out[i] = fn(a[i], b[i]);
+}
+
+void compareText(const std::string_view *column, std::string_view literal, bool equal, double *out, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) out[i] = (column[i] == literal) == equal;
+}
+
+const FieldName *findField(std::string_view name) {
+    for (const auto &field : kFieldNames) {
+        if (field.name == name) return &field;
+    }
+    return nullptr;
+}
+}
+
+// Recursive-descent parser that type-checks while it emits bytecode.
+class FilterExpression::Parser {
+public:
+    Parser(std::string_view text, FilterExpression &out) : text_(text), out_(out) {}
+
+    void parse() {
+        if (parseOr() != Type::Boolean) fail("filter must be a condition, e.g. price > 20");
+        skipSpace();
+        if (pos_ != text_.size()) fail("unexpected '" + std::string(text_.substr(pos_, 1)) + "'");
+    }
+
+private:
+    enum class Type {
+        Number,
+        Boolean
+    };
+
+    Type parseOr() {
+        Type type = parseAnd();
+        while (accept("||")) {
+            expect(type, Type::Boolean, "'||'");
+            expect(parseAnd(), Type::Boolean, "'||'");
+            emit(Op::Or);
+        }
+        return type;
+    }
+
+    Type parseAnd() {
+        Type type = parseUnary();
+        while (accept("&&")) {
+            expect(type, Type::Boolean, "'&&'");
+            expect(parseUnary(), Type::Boolean, "'&&'");
+            emit(Op::And);
+        }
+        return type;
+    }
+
+    Type parseUnary() {
+        if (peek("!") && !peek("!=")) {
+            accept("!");
+            expect(parseUnary(), Type::Boolean, "'!'");
+            emit(Op::Not);
+            return Type::Boolean;
+        }
+        return parseComparison();
+    }
+
+    Type parseComparison() {
+        if (const FieldName *field = peekField(); field && !field->numeric) {
+            return parseTextComparison(*field);
+        }
+
+        Type type = parseSum();
+        static constexpr std::pair<std::string_view, Op> kComparisons[] = {
+            {"<=", Op::LessEqual}, {">=", Op::GreaterEqual}, {"==", Op::Equal},
+            {"!=", Op::NotEqual},  {"<", Op::Less},          {">", Op::Greater},
+        };
+        for (const auto &[token, op] : kComparisons) {
+            if (!accept(token)) continue;
+            expect(type, Type::Number, "'" + std::string(token) + "'");
+            expect(parseSum(), Type::Number, "'" + std::string(token) + "'");
+            emit(op);
+            return Type::Boolean;
+        }
+        return type;
+    }
+
+    Type parseTextComparison(const FieldName &field) {
+        readIdentifier();
+        Op op;
+        if (accept("==")) {
+            op = Op::TextEqual;
+        } else if (accept("!=")) {
+            op = Op::TextNotEqual;
+        } else {
+            fail("text field '" + std::string(field.name) + "' can only be compared with == or !=");
+        }
+        Instruction instruction{op, field.field, false, static_cast<std::uint32_t>(out_.literals_.size()), 0.0};
+        out_.literals_.push_back(readString());
+        emit(instruction);
+        return Type::Boolean;
+    }
+
+    Type parseSum() {
+        Type type = parseProduct();
+        while (true) {
+            Op op;
+            if (accept("+")) {
+                op = Op::Add;
+            } else if (accept("-")) {
+                op = Op::Subtract;
+            } else {
+                return type;
+            }
+            expect(type, Type::Number, "arithmetic");
+            expect(parseProduct(), Type::Number, "arithmetic");
+            emit(op);
+        }
+    }
+
+    Type parseProduct() {
+        Type type = parseFactor();
+        while (true) {
+            Op op;
+            if (accept("*")) {
+                op = Op::Multiply;
+            } else if (accept("/")) {
+                op = Op::Divide;
+            } else {
+                return type;
+            }
+            expect(type, Type::Number, "arithmetic");
+            expect(parseFactor(), Type::Number, "arithmetic");
+            emit(op);
+        }
+    }
+
+    Type parseFactor() {
+        skipSpace();
+        if (accept("(")) {
+            Type type = parseOr();
+            if (!accept(")")) fail("expected ')'");
+            return type;
+        }
+        if (accept("-")) {
+            expect(parseFactor(), Type::Number, "'-'");
+            emit(Op::Negate);
+            return Type::Number;
+        }
+        if (pos_ < text_.size() && (std::isdigit(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '.')) {
+            double value = 0.0;
+            auto result = std::from_chars(text_.data() + pos_, text_.data() + text_.size(), value);
+            if (result.ec != std::errc()) fail("invalid number");
+            pos_ = static_cast<std::size_t>(result.ptr - text_.data());
+            emit({Op::Constant, 0, false, 0, value});
+            return Type::Number;
+        }
+        if (const FieldName *field = peekField()) {
+            if (!field->numeric) {
+                fail("text field '" + std::string(field->name) + "' can only be compared with == or !=");
+            }
+            readIdentifier();
+            emit({Op::Column, field->field, false, 0, 0.0});
+            return Type::Number;
+        }
+        if (pos_ < text_.size() && (std::isalpha(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_')) {
+            fail("unknown field '" + std::string(readIdentifier()) + "'");
+        }
+        fail(pos_ == text_.size() ? "unexpected end of expression" : "expected a number, field or '('");
+    }
+
+    void emit(Op op) { emit({op, 0, false, 0, 0.0}); }
+
+    void emit(const Instruction &instruction) {
+        switch (instruction.op) {
+        case Op::Column:
+        case Op::Constant:
+        case Op::TextEqual:
+        case Op::TextNotEqual:
+            ++depth_;
+            out_.max_depth_ = std::max(out_.max_depth_, depth_);
+            break;
+        case Op::Negate:
+        case Op::Not:
+            break;
+        default:
+            --depth_;
+            // A binary operator whose right operand is a constant takes the
+            // constant as an immediate instead of a filled stack row.
+            if (!out_.code_.empty() && out_.code_.back().op == Op::Constant) {
+                Instruction fused = instruction;
+                fused.immediate = true;
+                fused.value = out_.code_.back().value;
+                out_.code_.back() = fused;
+                return;
+            }
+            break;
+        }
+        out_.code_.push_back(instruction);
+    }
+
+    void expect(Type actual, Type wanted, const std::string &context) {
+        if (actual == wanted) return;
+        fail(context + (wanted == Type::Number ? " needs numbers" : " needs conditions"));
+    }
+
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    }
+
+    bool peek(std::string_view token) {
+        skipSpace();
+        return text_.substr(pos_, token.size()) == token;
+    }
+
+    bool accept(std::string_view token) {
+        if (!peek(token)) return false;
+        pos_ += token.size();
+        return true;
+    }
+
+    const FieldName *peekField() {
+        skipSpace();
+        std::size_t end = pos_;
+        while (end < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[end])) || text_[end] == '_')) ++end;
+        if (end == pos_ || std::isdigit(static_cast<unsigned char>(text_[pos_]))) return nullptr;
+        return findField(text_.substr(pos_, end - pos_));
+    }
+
+    std::string_view readIdentifier() {
+        skipSpace();
+        std::size_t begin = pos_;
+        while (pos_ < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_')) ++pos_;
+        return text_.substr(begin, pos_ - begin);
+    }
+
+    std::string readString() {
+        skipSpace();
+        if (pos_ == text_.size() || (text_[pos_] != '"' && text_[pos_] != '\'')) fail("expected a quoted string");
+        char quote = text_[pos_];
+        std::size_t end = text_.find(quote, pos_ + 1);
+        if (end == std::string_view::npos) fail("unterminated string");
+        std::string value(text_.substr(pos_ + 1, end - pos_ - 1));
+        pos_ = end + 1;
+        return value;
+    }
+
+    [[noreturn]] void fail(const std::string &message) const {
+        throw std::invalid_argument("Invalid filter at offset " + std::to_string(pos_) + ": " + message);
+    }
+
+    std::string_view text_;
+    FilterExpression &out_;
+    std::size_t pos_{0};
+    std::size_t depth_{0};
+};
+
+FilterExpression FilterExpression::compile(std::string_view text) {
+    FilterExpression expression;
+    expression.text_ = text;
+    Parser(expression.text_, expression).parse();
+    return expression;
+}
+
+void FilterExpression::select(const QuoteColumns &columns, std::vector<std::uint32_t> &selection) const {
+    // Stack entry k points at a column slice or at one of two scratch rows
+    // owned by depth k. Results go to the row the entry is not using, so a
+    // kernel's output never overlaps its inputs and the loops vectorize.
+    thread_local std::vector<double> scratch;
+    thread_local std::vector<const double *> stack;
+    scratch.resize(2 * max_depth_ * kBatch);
+    stack.resize(max_depth_);
+
+    std::size_t count = columns.size();
+    selection.resize(count);
+    std::size_t selected = 0;
+
+    for (std::size_t base = 0; base < count; base += kBatch) {
+        std::size_t len = std::min(kBatch, count - base);
+        std::size_t top = 0;
+        auto slot = [&](std::size_t depth) {
+            double *row = scratch.data() + 2 * depth * kBatch;
+            return stack[depth] == row ? row + kBatch : row;
+        };
+        auto unary = [&](auto fn) {
+            double *out = slot(top - 1);
+            applyUnary(stack[top - 1], out, len, fn);
+            stack[top - 1] = out;
+        };
+        auto binary = [&](const Instruction &instruction, auto fn) {
+            if (instruction.immediate) {
+                double *out = slot(top - 1);
+                double b = instruction.value;
+                applyUnary(stack[top - 1], out, len, [fn, b](double a) { return fn(a, b); });
+                stack[top - 1] = out;
+                return;
+            }
+            double *out = slot(top - 2);
+            applyBinary(stack[top - 2], stack[top - 1], out, len, fn);
+            stack[top - 2] = out;
+            --top;
+        };
+        auto text = [&](const Instruction &instruction, bool equal) {
+            double *out = slot(top);
+            compareText(columns.text[instruction.field].data() + base, literals_[instruction.literal], equal, out, len);
+            stack[top++] = out;
+        };
+
+        for (const Instruction &instruction : code_) {
+            switch (instruction.op) {
+            case Op::Column:
+                stack[top++] = columns.numeric[instruction.field].data() + base;
+                break;
+            case Op::Constant: {
+                double *out = slot(top);
+                std::fill(out, out + len, instruction.value);
+                stack[top++] = out;
+                break;
+            }
+            case Op::Add:
+                binary(instruction, [](double a, double b) { return a + b; });
+                break;
+            case Op::Subtract:
+                binary(instruction, [](double a, double b) { return a - b; });
+                break;
+            case Op::Multiply:
+                binary(instruction, [](double a, double b) { return a * b; });
+                break;
+            case Op::Divide:
+                binary(instruction, [](double a, double b) { return a / b; });
+                break;
+            case Op::Negate:
+                unary([](double a) { return -a; });
+                break;
+            case Op::Less:
+                binary(instruction, [](double a, double b) { return static_cast<double>(a < b); });
+                break;
+            case Op::LessEqual:
+                binary(instruction, [](double a, double b) { return static_cast<double>(a <= b); });
+                break;
+            case Op::Greater:
+                binary(instruction, [](double a, double b) { return static_cast<double>(a > b); });
+                break;
+            case Op::GreaterEqual:
+                binary(instruction, [](double a, double b) { return static_cast<double>(a >= b); });
+                break;
+            case Op::Equal:
+                binary(instruction, [](double a, double b) { return static_cast<double>(a == b); });
+                break;
+            case Op::NotEqual:
+                binary(instruction, [](double a, double b) { return static_cast<double>(a != b); });
+                break;
+            case Op::And:
+                binary(instruction, [](double a, double b) { return static_cast<double>((a != 0.0) & (b != 0.0)); });
+                break;
+            case Op::Or:
+                binary(instruction, [](double a, double b) { return static_cast<double>((a != 0.0) | (b != 0.0)); });
+                break;
+            case Op::Not:
+                unary([](double a) { return static_cast<double>(a == 0.0); });
+                break;
+            case Op::TextEqual:
+                text(instruction, true);
+                break;
+            case Op::TextNotEqual:
+                text(instruction, false);
+                break;
+            }
+        }
+
+        const double *result = stack[0];
+        for (std::size_t i = 0; i < len; ++i) {
+            selection[selected] = static_cast<std::uint32_t>(base + i);
+            selected += result[i] != 0.0;
+        }
+    }
+    selection.resize(selected);
+}
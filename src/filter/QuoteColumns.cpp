@@ -0,0 +1,35 @@
+#include "quantis/filter/QuoteColumns.hpp"
+
+void QuoteColumns::resize(std::size_t count) {
+    for (auto &column : numeric) column.resize(count);
+    for (auto &column : text) column.resize(count);
+}
+
+void QuoteColumns::set(std::size_t row, const TickerRecord &meta, const Quote &q, std::string_view name) {
+    auto column = [this, row](NumericField field) -> double & { return numeric[static_cast<std::size_t>(field)][row]; };
+    column(NumericField::Price) = q.price;
+    column(NumericField::MarketCap) = q.market_cap;
+    column(NumericField::DailyPercentChange) = q.daily_percent_change;
+    column(NumericField::Volume) = static_cast<double>(q.volume);
+    column(NumericField::AverageVolume) = static_cast<double>(q.average_volume);
+    column(NumericField::FiftyTwoWeekHigh) = q.fiftytwo_week_high;
+    column(NumericField::FiftyTwoWeekLow) = q.fiftytwo_week_low;
+    column(NumericField::Bid) = q.bid;
+    column(NumericField::Ask) = q.ask;
+
+    auto field = [this, row](TextField field) -> std::string_view & { return text[static_cast<std::size_t>(field)][row]; };
+    field(TextField::Ticker) = meta.ticker;
+    field(TextField::Name) = name;
+    field(TextField::Sector) = meta.sector;
+    field(TextField::Industry) = meta.industry;
+    field(TextField::Notes) = meta.notes;
+    field(TextField::DateAdded) = meta.date_added;
+}
+
+void QuoteColumns::load(const ScreenerRows &rows, const SymbolTable *names) {
+    resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const auto &meta = *rows[i].first;
+        set(i, meta, rows[i].second, names ? names->displayName(meta.id, meta.name) : std::string_view(meta.name));
+    }
+}
@@ -1,17 +1,20 @@
-#include "MarketDataProvider.hpp"
 #include "ScreenerEngine.hpp"
 #include "Storage.hpp"
+#include "SyntheticMarketData.hpp"
 #include "TableRenderer.hpp"
-#include "quantis/anomaly/AnomalyEngine.hpp"
 #include <iostream>
 
 int main(int argc, char **argv) {
+    // With a daemon running, screener commands are answered from its warm
+    // state without opening the database here.
+    if (auto status = ScreenerEngine::forwardToDaemon(argc, argv)) {
+        return *status;
+    }
     try {
         Storage storage("quantis.db");
-        MarketDataProvider provider;
-        TableRenderer renderer;
-        AnomalyEngine anomaly;
-        ScreenerEngine engine(storage, provider, renderer, anomaly);
+        SyntheticMarketData provider(storage.symbols());
+        TableRenderer renderer(storage.symbols());
+        ScreenerEngine engine(storage, provider, renderer);
         return engine.run(argc, argv);
     } catch (const std::exception &ex) {
         std::cerr << "Fatal error: " << ex.what() << "\n";
@@ -0,0 +1,35 @@
+#include "quantis/metrics/LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+void LatencyHistogram::record(std::uint64_t ns, std::uint64_t count) {
+    counts_[latency_histogram::bucketFor(ns)] += count;
+    count_ += count;
+    sum_ += ns * count;
+    max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) { add(other.counts_, other.sum_, other.max_); }
+
+void LatencyHistogram::add(std::span<const std::uint64_t> buckets, std::uint64_t sum, std::uint64_t max) {
+    for (std::size_t i = 0; i < counts_.size() && i < buckets.size(); ++i) {
+        counts_[i] += buckets[i];
+        count_ += buckets[i];
+    }
+    sum_ += sum;
+    max_ = std::max(max_, max);
+}
+
+void LatencyHistogram::clear() { *this = LatencyHistogram{}; }
+
+std::uint64_t LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) return 0;
+    auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_)));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) return std::min(latency_histogram::bucketUpperBound(i), max_);
+    }
+    return max_;
+}
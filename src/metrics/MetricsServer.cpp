@@ -0,0 +1,219 @@
+#include "quantis/metrics/MetricsServer.hpp"
+#include "quantis/feed/FeedProtocol.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <string_view>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::size_t kMaxRequest = 8192;
+// A client that has not sent its request line by then is dropped.
+constexpr int kRequestTimeoutMs = 1000;
+constexpr std::array<double, 3> kQuantiles{0.5, 0.99, 0.999};
+
+double seconds(std::uint64_t ns) { return static_cast<double>(ns) / 1e9; }
+
+void appendf(std::string &out, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+void appendf(std::string &out, const char *format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int written = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (written > 0) out.append(line, std::min<std::size_t>(static_cast<std::size_t>(written), sizeof(line) - 1));
+}
+
+void appendHeader(std::string &out, const char *name, const char *type, const char *help) {
+    appendf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// One summary series; `labels` is empty or "name=\"value\"," ready to prefix.
+void appendSummary(std::string &out, const char *name, const std::string &labels,
+                   const MetricsSnapshot::Summary &summary) {
+    const double values[] = {summary.p50, summary.p99, summary.p999};
+    for (std::size_t i = 0; i < kQuantiles.size(); ++i) {
+        appendf(out, "%s{%squantile=\"%g\"} %.9g\n", name, labels.c_str(), kQuantiles[i], values[i]);
+    }
+    std::string bare = labels.empty() ? "" : "{" + labels.substr(0, labels.size() - 1) + "}";
+    appendf(out, "%s_sum%s %.9g\n", name, bare.c_str(), summary.sum);
+    appendf(out, "%s_count%s %" PRIu64 "\n", name, bare.c_str(), summary.count);
+}
+
+const MetricsSnapshot::Summary &stage(const MetricsSnapshot &snapshot, Stage which) {
+    return snapshot.stages[static_cast<std::size_t>(which)];
+}
+
+std::uint64_t frames(const MetricsSnapshot &snapshot, FrameCounter which) {
+    return snapshot.frames[static_cast<std::size_t>(which)];
+}
+
+bool sendAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(sent));
+    }
+    return true;
+}
+}
+
+MetricsSnapshot MetricsSnapshot::from(const StageMetrics::Snapshot &metrics, std::uint64_t tracked_tickers,
+                                      double interval_seconds) {
+    MetricsSnapshot snapshot;
+    for (std::size_t s = 0; s < kStageCount; ++s) {
+        const LatencyHistogram &histogram = metrics.stages[s];
+        snapshot.stages[s] = Summary{seconds(histogram.percentile(0.5)), seconds(histogram.percentile(0.99)),
+                                     seconds(histogram.percentile(0.999)), seconds(histogram.sum()),
+                                     histogram.count()};
+    }
+    snapshot.frames = metrics.frames;
+    snapshot.alerts = metrics.alerts;
+    snapshot.tracked_tickers = tracked_tickers;
+    snapshot.interval_seconds = interval_seconds;
+    snapshot.uptime_seconds = metrics.seconds;
+    return snapshot;
+}
+
+void appendPrometheusText(std::string &out, const MetricsSnapshot &snapshot, std::uint64_t resident_bytes) {
+    appendHeader(out, "quantis_ticks_total", "counter", "Realtime ticks fetched.");
+    appendf(out, "quantis_ticks_total %" PRIu64 "\n", frames(snapshot, FrameCounter::Fetched));
+    appendHeader(out, "quantis_ticks_skipped_total", "counter", "Ticks skipped because the previous one overran.");
+    appendf(out, "quantis_ticks_skipped_total %" PRIu64 "\n", frames(snapshot, FrameCounter::Skipped));
+    appendHeader(out, "quantis_frames_total", "counter", "Realtime frames by what happened to them.");
+    for (FrameCounter counter : {FrameCounter::Evaluated, FrameCounter::Dropped, FrameCounter::Drawn}) {
+        appendf(out, "quantis_frames_total{outcome=\"%s\"} %" PRIu64 "\n", frameCounterName(counter).data(),
+                frames(snapshot, counter));
+    }
+
+    appendHeader(out, "quantis_tick_interval_seconds", "gauge", "Configured realtime tick period.");
+    appendf(out, "quantis_tick_interval_seconds %.9g\n", snapshot.interval_seconds);
+    appendHeader(out, "quantis_tick_jitter_seconds", "summary", "How late each tick started against its deadline.");
+    appendSummary(out, "quantis_tick_jitter_seconds", "", stage(snapshot, Stage::TickJitter));
+
+    appendHeader(out, "quantis_stage_duration_seconds", "summary",
+                 "Time per realtime frame by pipeline stage; render is format plus write.");
+    for (Stage which : {Stage::Load, Stage::Fetch, Stage::Evaluate, Stage::Format, Stage::Write}) {
+        appendSummary(out, "quantis_stage_duration_seconds", "stage=\"" + std::string(stageName(which)) + "\",",
+                      stage(snapshot, which));
+    }
+    appendHeader(out, "quantis_tick_to_alert_seconds", "summary",
+                 "Quote source timestamp to its alerts being known.");
+    appendSummary(out, "quantis_tick_to_alert_seconds", "", stage(snapshot, Stage::TickToAlert));
+
+    appendHeader(out, "quantis_alerts_total", "counter", "Alerts raised, by rule.");
+    for (std::size_t rule = 0; rule < kAlertCount; ++rule) {
+        appendf(out, "quantis_alerts_total{rule=\"%s\"} %" PRIu64 "\n", kAlertTable[rule].name.data(),
+                snapshot.alerts[rule]);
+    }
+
+    appendHeader(out, "quantis_tracked_tickers", "gauge", "Tickers in the watchlist.");
+    appendf(out, "quantis_tracked_tickers %" PRIu64 "\n", snapshot.tracked_tickers);
+    appendHeader(out, "quantis_uptime_seconds", "gauge", "Time since the realtime session started.");
+    appendf(out, "quantis_uptime_seconds %.3f\n", snapshot.uptime_seconds);
+    appendHeader(out, "process_resident_memory_bytes", "gauge", "Resident memory size in bytes.");
+    appendf(out, "process_resident_memory_bytes %" PRIu64 "\n", resident_bytes);
+}
+
+std::uint64_t residentBytes() {
+    std::FILE *statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    int fields = std::fscanf(statm, "%llu %llu", &size, &resident);
+    std::fclose(statm);
+    long page = ::sysconf(_SC_PAGESIZE);
+    return fields == 2 && page > 0 ? resident * static_cast<std::uint64_t>(page) : 0;
+}
+
+MetricsServer::MetricsServer(std::uint16_t port) : port_(port) {
+    FeedEndpoint endpoint;
+    endpoint.host = "127.0.0.1";
+    endpoint.port = port;
+    listen_fd_ = listenFeed(endpoint);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("Cannot serve metrics on " + endpoint.text() + ": " + std::strerror(errno));
+    }
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        std::string error = std::strerror(errno);
+        ::close(listen_fd_);
+        throw std::runtime_error("Cannot start metrics server: " + error);
+    }
+    thread_ = std::thread([this] { serve(); });
+}
+
+MetricsServer::~MetricsServer() {
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto written = ::write(wake_fd_, &one, sizeof(one));
+    thread_.join();
+    ::close(wake_fd_);
+    ::close(listen_fd_);
+}
+
+void MetricsServer::serve() {
+    pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    while (true) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents) return;
+        if (!(fds[0].revents & POLLIN)) continue;
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        timeval timeout{kRequestTimeoutMs / 1000, (kRequestTimeoutMs % 1000) * 1000};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        respond(fd);
+        ::close(fd);
+    }
+}
+
+// One request per connection, answered and closed: enough for a scraper or
+// curl, with nothing kept between requests but the response buffer.
+void MetricsServer::respond(int fd) {
+    char request[kMaxRequest];
+    std::size_t length = 0;
+    std::string_view line;
+    while (length < sizeof(request)) {
+        ssize_t received = ::recv(fd, request + length, sizeof(request) - length, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return;
+        length += static_cast<std::size_t>(received);
+        // Read the whole header block: closing with request bytes unread
+        // would reset the connection under the client's feet.
+        std::string_view seen(request, length);
+        if (seen.find("\r\n\r\n") != std::string_view::npos) {
+            line = seen.substr(0, seen.find("\r\n"));
+            break;
+        }
+    }
+    if (line.empty()) return;
+
+    bool found = line.starts_with("GET /metrics ") || line.starts_with("GET /metrics?");
+    std::string body;
+    if (found) {
+        appendPrometheusText(body, published_.latest(), residentBytes());
+    } else {
+        body = "Not found; metrics are at /metrics\n";
+    }
+    response_.clear();
+    appendf(response_,
+            "HTTP/1.0 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+            found ? "200 OK" : "404 Not Found", found ? "text/plain; version=0.0.4" : "text/plain", body.size());
+    response_ += body;
+    sendAll(fd, response_);
+}
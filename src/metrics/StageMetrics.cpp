@@ -0,0 +1,210 @@
+#include "quantis/metrics/StageMetrics.hpp"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr std::array<std::string_view, kStageCount> kStageNames{
+    "load", "fetch", "evaluate", "format", "write", "tick_to_alert", "tick_jitter"};
+constexpr std::array<std::string_view, kFrameCounterCount> kFrameCounterNames{
+    "fetched", "skipped", "evaluated", "dropped", "drawn"};
+
+// Stats file: StatsHeader, then per stage its sum, max and kBuckets counts,
+// then the frame and alert counters, all little-endian u64.
+constexpr char kStatsMagic[8] = {'Q', 'S', 'T', 'A', 'T', 'S', '0', '1'};
+
+struct StatsHeader {
+    char magic[8];
+    std::uint32_t stages;
+    std::uint32_t buckets;
+    std::uint32_t frame_counters;
+    std::uint32_t alert_rules;
+    double seconds;
+    std::int64_t taken_at;
+};
+
+std::atomic<std::uint64_t> g_next_id{1};
+
+std::string formatDuration(std::uint64_t ns) {
+    char text[32];
+    if (ns < 1000) {
+        std::snprintf(text, sizeof(text), "%lluns", static_cast<unsigned long long>(ns));
+    } else if (ns < 1000000) {
+        std::snprintf(text, sizeof(text), "%.1fus", static_cast<double>(ns) / 1e3);
+    } else if (ns < 1000000000) {
+        std::snprintf(text, sizeof(text), "%.2fms", static_cast<double>(ns) / 1e6);
+    } else {
+        std::snprintf(text, sizeof(text), "%.2fs", static_cast<double>(ns) / 1e9);
+    }
+    return text;
+}
+}
+
+std::string_view stageName(Stage stage) { return kStageNames[static_cast<std::size_t>(stage)]; }
+
+std::string_view frameCounterName(FrameCounter counter) {
+    return kFrameCounterNames[static_cast<std::size_t>(counter)];
+}
+
+StageMetrics::StageMetrics() : id_(g_next_id.fetch_add(1)), start_(std::chrono::steady_clock::now()) {}
+
+StageMetrics::~StageMetrics() {
+    for (Slot *slot = slots_.load(); slot;) {
+        delete std::exchange(slot, slot->next);
+    }
+}
+
+StageMetrics::Slot &StageMetrics::local() {
+    // Instance ids are never reused, so a stale entry cannot match.
+    thread_local std::vector<std::pair<std::uint64_t, Slot *>> slots;
+    for (auto &[id, slot] : slots) {
+        if (id == id_) return *slot;
+    }
+    Slot &slot = registerThread();
+    slots.emplace_back(id_, &slot);
+    return slot;
+}
+
+StageMetrics::Slot &StageMetrics::registerThread() {
+    auto *slot = new Slot();
+    slot->next = slots_.load(std::memory_order_relaxed);
+    while (!slots_.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return *slot;
+}
+
+void StageMetrics::recordAlerts(std::span<const Quote> quotes, std::span<const AlertSet> alerts,
+                                std::int64_t now_ns) {
+    Slot &slot = local();
+    std::array<std::uint64_t, kAlertCount> raised{};
+    for (std::size_t i = 0; i < quotes.size(); ++i) {
+        std::int64_t source = quotes[i].timestamp_ns;
+        if (source > 0) {
+            slot.record(Stage::TickToAlert, now_ns > source ? static_cast<std::uint64_t>(now_ns - source) : 0);
+        }
+        AlertSet set = i < alerts.size() ? alerts[i] : 0;
+        for (std::size_t rule = 0; set != 0 && rule < kAlertCount; ++rule) {
+            raised[rule] += (set >> rule) & 1u;
+        }
+    }
+    for (std::size_t rule = 0; rule < kAlertCount; ++rule) {
+        if (raised[rule]) Slot::add(slot.alerts[rule], raised[rule]);
+    }
+}
+
+std::unique_ptr<StageMetrics::Snapshot> StageMetrics::snapshot() const {
+    auto snapshot = std::make_unique<Snapshot>();
+    snapshot->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    snapshot->taken_at = static_cast<std::int64_t>(std::time(nullptr));
+
+    std::vector<std::uint64_t> buckets(latency_histogram::kBuckets);
+    for (const Slot *slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+        for (std::size_t s = 0; s < kStageCount; ++s) {
+            for (std::size_t b = 0; b < buckets.size(); ++b) {
+                buckets[b] = slot->buckets[s][b].load(std::memory_order_relaxed);
+            }
+            snapshot->stages[s].add(buckets, slot->sums[s].load(std::memory_order_relaxed),
+                                    slot->maxes[s].load(std::memory_order_relaxed));
+        }
+        for (std::size_t c = 0; c < kFrameCounterCount; ++c) {
+            snapshot->frames[c] += slot->frames[c].load(std::memory_order_relaxed);
+        }
+        for (std::size_t rule = 0; rule < kAlertCount; ++rule) {
+            snapshot->alerts[rule] += slot->alerts[rule].load(std::memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+void printSummary(std::ostream &out, const StageMetrics::Snapshot &snapshot) {
+    char when[32] = "unknown time";
+    std::time_t taken_at = static_cast<std::time_t>(snapshot.taken_at);
+    std::tm local{};
+    if (localtime_r(&taken_at, &local)) {
+        std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &local);
+    }
+    out << std::fixed << std::setprecision(1) << "Realtime session of " << snapshot.seconds << " s, recorded "
+        << when << "\n"
+        << std::left << std::setw(16) << "Stage" << std::right << std::setw(12) << "count" << std::setw(11) << "p50"
+        << std::setw(11) << "p99" << std::setw(11) << "p999" << std::setw(11) << "max" << std::setw(11) << "mean"
+        << "\n";
+    for (std::size_t s = 0; s < kStageCount; ++s) {
+        const LatencyHistogram &histogram = snapshot.stages[s];
+        out << std::left << std::setw(16) << kStageNames[s] << std::right << std::setw(12) << histogram.count();
+        if (histogram.count() == 0) {
+            out << std::setw(11) << "-" << std::setw(11) << "-" << std::setw(11) << "-" << std::setw(11) << "-"
+                << std::setw(11) << "-" << "\n";
+            continue;
+        }
+        out << std::setw(11) << formatDuration(histogram.percentile(0.50)) << std::setw(11)
+            << formatDuration(histogram.percentile(0.99)) << std::setw(11)
+            << formatDuration(histogram.percentile(0.999)) << std::setw(11) << formatDuration(histogram.max())
+            << std::setw(11) << formatDuration(static_cast<std::uint64_t>(histogram.mean())) << "\n";
+    }
+
+    out << "Frames:";
+    for (std::size_t c = 0; c < kFrameCounterCount; ++c) {
+        out << (c ? ", " : " ") << snapshot.frames[c] << " " << kFrameCounterNames[c];
+    }
+    out << "\nAlerts raised:";
+    for (std::size_t rule = 0; rule < kAlertCount; ++rule) {
+        out << (rule ? ", " : " ") << kAlertTable[rule].name << " " << snapshot.alerts[rule];
+    }
+    out << "\n";
+}
+
+bool saveSnapshot(const std::string &path, const StageMetrics::Snapshot &snapshot) {
+    StatsHeader header{};
+    std::memcpy(header.magic, kStatsMagic, sizeof(kStatsMagic));
+    header.stages = kStageCount;
+    header.buckets = latency_histogram::kBuckets;
+    header.frame_counters = kFrameCounterCount;
+    header.alert_rules = kAlertCount;
+    header.seconds = snapshot.seconds;
+    header.taken_at = snapshot.taken_at;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    auto write = [&](const void *data, std::size_t bytes) {
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+    };
+    write(&header, sizeof(header));
+    for (const auto &histogram : snapshot.stages) {
+        std::uint64_t totals[2] = {histogram.sum(), histogram.max()};
+        write(totals, sizeof(totals));
+        write(histogram.buckets().data(), histogram.buckets().size_bytes());
+    }
+    write(snapshot.frames.data(), sizeof(snapshot.frames));
+    write(snapshot.alerts.data(), sizeof(snapshot.alerts));
+    return static_cast<bool>(out.flush());
+}
+
+bool loadSnapshot(const std::string &path, StageMetrics::Snapshot &snapshot) {
+    std::ifstream in(path, std::ios::binary);
+    auto read = [&](void *data, std::size_t bytes) {
+        return static_cast<bool>(in.read(static_cast<char *>(data), static_cast<std::streamsize>(bytes)));
+    };
+    StatsHeader header{};
+    if (!read(&header, sizeof(header)) || std::memcmp(header.magic, kStatsMagic, sizeof(kStatsMagic)) != 0 ||
+        header.stages != kStageCount || header.buckets != latency_histogram::kBuckets ||
+        header.frame_counters != kFrameCounterCount || header.alert_rules != kAlertCount) {
+        return false;
+    }
+    snapshot = StageMetrics::Snapshot{};
+    snapshot.seconds = header.seconds;
+    snapshot.taken_at = header.taken_at;
+    std::vector<std::uint64_t> buckets(latency_histogram::kBuckets);
+    for (auto &histogram : snapshot.stages) {
+        std::uint64_t totals[2];
+        if (!read(totals, sizeof(totals)) || !read(buckets.data(), buckets.size() * sizeof(std::uint64_t))) {
+            return false;
+        }
+        histogram.add(buckets, totals[0], totals[1]);
+    }
+    return read(snapshot.frames.data(), sizeof(snapshot.frames)) &&
+           read(snapshot.alerts.data(), sizeof(snapshot.alerts));
+}
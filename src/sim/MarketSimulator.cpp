@@ -0,0 +1,245 @@
+#include "quantis/sim/MarketSimulator.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+constexpr std::size_t kBatch = 256;
+constexpr std::uint64_t kSessionMinutes = 390;
+constexpr double kMinutesPerYear = 252.0 * kSessionMinutes;
+
+// Counter layout per ticker: kInitDraws values seed the ticker, then each
+// tick consumes kDrawsPerTick.
+constexpr std::uint64_t kInitDraws = 8;
+constexpr std::uint64_t kDrawsPerTick = 4;
+
+constexpr double kShockProbability = 0.0005; // per ticker per minute
+constexpr double kShockSize = 0.08;          // largest shock, in log price
+constexpr double kShockSpread = 6.0;         // spread on a shock, in base spreads
+constexpr double kShockActivity = 20.0;      // extra volume rate right after a shock
+constexpr double kActivityDecay = 0.98;      // per minute, a half-life of about 34 minutes
+constexpr double kSpreadReversion = 0.2;
+constexpr double kSpreadNoise = 0.1;
+constexpr double kMinSpread = 0.01;
+constexpr double kAverageVolumeWeight = 0.2;
+
+constexpr std::uint64_t kGamma = 0x9e3779b97f4a7c15ULL;
+
+// SplitMix64's output function. mix(key + n * kGamma) is the n-th value of
+// the SplitMix64 stream for `key`, so any draw can be computed directly from
+// its counter.
+inline std::uint64_t mix(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline std::uint64_t draw(std::uint64_t key, std::uint64_t counter) { return mix(key + counter * kGamma); }
+
+// Exact for values below 2^52, using only integer ops and a subtract so the
+// loops stay vectorizable without AVX-512 conversions.
+inline double toDouble(std::uint64_t value) {
+    return std::bit_cast<double>(0x4330000000000000ULL | value) - 0x1p52;
+}
+
+// Uniform in [0, 1) from the top 32 bits.
+inline double unit32(std::uint64_t bits) { return toDouble(bits >> 32) * 0x1p-32; }
+
+inline std::uint64_t laneSum(std::uint64_t bits) {
+    return (bits & 0xffff) + ((bits >> 16) & 0xffff) + ((bits >> 32) & 0xffff) + (bits >> 48);
+}
+
+// Approximate standard normals by the Irwin-Hall sum of 16-bit uniform lanes:
+// eight lanes for price returns, four for spread noise. Branch-free, and
+// bounded at about 4.9 and 3.5 standard deviations.
+constexpr double kLaneMean = 32767.5;
+constexpr double kLaneVariance = (65536.0 * 65536.0 - 1.0) / 12.0;
+const double kNormal8Scale = 1.0 / std::sqrt(8.0 * kLaneVariance);
+const double kNormal4Scale = 1.0 / std::sqrt(4.0 * kLaneVariance);
+
+inline double normal8(std::uint64_t a, std::uint64_t b) {
+    return (toDouble(laneSum(a) + laneSum(b)) - 8.0 * kLaneMean) * kNormal8Scale;
+}
+
+inline double normal4(std::uint64_t bits) { return (toDouble(laneSum(bits)) - 4.0 * kLaneMean) * kNormal4Scale; }
+
+// exp(x) for one minute's log return: degree-6 Taylor, relative error below
+// 1e-8 for |x| <= 0.2. Unlike std::exp it vectorizes and gives the same bits
+// on every target.
+inline double expSmall(double x) {
+    return 1.0 + x * (1.0 + x * (1.0 / 2 + x * (1.0 / 6 + x * (1.0 / 24 + x * (1.0 / 120 + x * (1.0 / 720))))));
+}
+
+// A batch of ticker state laid out by field for the tick loop.
+struct Batch {
+    std::uint64_t key[kBatch];
+    double price[kBatch];
+    double drift[kBatch];
+    double volatility[kBatch];
+    double spread[kBatch];
+    double base_spread[kBatch];
+    double day_open[kBatch];
+    double day_volume[kBatch];
+    double average_volume[kBatch];
+    double high[kBatch];
+    double low[kBatch];
+    double activity[kBatch];
+};
+
+// One minute for every ticker in the batch.
+void advanceBatch(Batch &b, std::size_t count, std::uint64_t counter, double minute_share) {
+    for (std::size_t j = 0; j < count; ++j) {
+        const std::uint64_t key = b.key[j];
+        const double z = normal8(draw(key, counter), draw(key, counter + 1));
+        const double z_spread = normal4(draw(key, counter + 2));
+        // Top 32 bits decide a shock, the low lanes size it and the volume.
+        const std::uint64_t events = draw(key, counter + 3);
+        const double shock = unit32(events) < kShockProbability ? 1.0 : 0.0;
+        const double jump = toDouble(events & 0xffff) * (2.0 / 65535.0) - 1.0;
+        const double noise = toDouble((events >> 16) & 0xffff) * (1.0 / 65535.0);
+
+        const double price = b.price[j] * expSmall(b.drift[j] + b.volatility[j] * z + shock * kShockSize * jump);
+        // Trading stays heavy for a while after news.
+        const double activity = b.activity[j] * kActivityDecay + shock * kShockActivity;
+        b.activity[j] = activity;
+        b.day_volume[j] += b.average_volume[j] * minute_share * (0.5 + noise) * (1.0 + activity);
+
+        // Ornstein-Uhlenbeck spread around a base that scales with price.
+        const double target = b.base_spread[j] * price;
+        double spread = b.spread[j] + kSpreadReversion * (target - b.spread[j]) + kSpreadNoise * target * z_spread;
+        spread = std::max(spread, kMinSpread);
+        spread = std::max(spread, shock * kShockSpread * target);
+        b.spread[j] = spread;
+
+        b.price[j] = price;
+        b.high[j] = std::max(b.high[j], price);
+        b.low[j] = std::min(b.low[j], price);
+    }
+}
+}
+
+MarketSimulator::MarketSimulator(std::uint64_t seed) : seed_(seed) {}
+
+void MarketSimulator::advance(std::size_t universe) {
+    ++tick_;
+    extend(universe);
+}
+
+void MarketSimulator::extend(std::size_t universe) {
+    while (state_.size() < universe) {
+        state_.push_back(initialState(static_cast<TickerId>(state_.size())));
+    }
+}
+
+MarketSimulator::TickerState MarketSimulator::initialState(TickerId id) const {
+    TickerState s{};
+    s.key = draw(seed_, static_cast<std::uint64_t>(id) + 1);
+    double u[kInitDraws];
+    for (std::uint64_t d = 0; d < kInitDraws; ++d) {
+        u[d] = unit32(draw(s.key, d));
+    }
+
+    s.price = 10.0 * std::exp(u[0] * std::log(50.0)); // 10 to 500, log-uniform
+    double sigma = 0.15 + 0.5 * u[1];                  // annual volatility
+    double mu = -0.05 + 0.2 * u[2];                    // annual drift
+    s.volatility = sigma / std::sqrt(kMinutesPerYear);
+    s.drift = (mu - 0.5 * sigma * sigma) / kMinutesPerYear;
+    s.base_spread = 2e-4 * std::exp(u[3] * std::log(10.0)); // 2 to 20 bps
+    s.spread = s.base_spread * s.price;
+    s.average_volume = 2e5 * std::exp(u[4] * std::log(250.0));
+    s.high = s.price * (1.05 + 0.45 * u[5]);
+    s.low = s.price * (0.95 - 0.4 * u[6]);
+    s.shares = 1e9 * std::exp(u[7] * std::log(2000.0)) / s.price;
+    s.day_open = s.price;
+    s.day_volume = 0.0;
+    s.activity = 0.0;
+    return s;
+}
+
+void MarketSimulator::step(std::span<const TickerId> ids, std::span<Quote> quotes) {
+    if (ids.size() != quotes.size()) {
+        throw std::invalid_argument("MarketSimulator::step: mismatched batch sizes");
+    }
+    if (tick_ == 0) {
+        throw std::logic_error("MarketSimulator::step called before advance");
+    }
+
+    const std::uint64_t minute = (tick_ - 1) % kSessionMinutes;
+    const bool new_day = minute == 0 && tick_ > 1;
+    const std::uint64_t counter = kInitDraws + (tick_ - 1) * kDrawsPerTick;
+    // U-shaped intraday curve, busiest at the open and close; averages one
+    // day's volume over the session.
+    const double session = (static_cast<double>(minute) + 0.5) / kSessionMinutes - 0.5;
+    const double minute_share = (0.5 + 6.0 * session * session) / kSessionMinutes;
+
+    Batch b;
+    for (std::size_t base = 0; base < ids.size(); base += kBatch) {
+        const std::size_t count = std::min(kBatch, ids.size() - base);
+
+        for (std::size_t j = 0; j < count; ++j) {
+            const TickerState &s = state_[ids[base + j]];
+            b.key[j] = s.key;
+            b.price[j] = s.price;
+            b.drift[j] = s.drift;
+            b.volatility[j] = s.volatility;
+            b.spread[j] = s.spread;
+            b.base_spread[j] = s.base_spread;
+            b.day_open[j] = s.day_open;
+            b.day_volume[j] = s.day_volume;
+            b.average_volume[j] = s.average_volume;
+            b.high[j] = s.high;
+            b.low[j] = s.low;
+            b.activity[j] = s.activity;
+        }
+
+        // The previous close opens the new day and its volume folds into the
+        // running daily average.
+        if (new_day) {
+            for (std::size_t j = 0; j < count; ++j) {
+                b.day_open[j] = b.price[j];
+                b.average_volume[j] =
+                    b.average_volume[j] * (1.0 - kAverageVolumeWeight) + b.day_volume[j] * kAverageVolumeWeight;
+                b.day_volume[j] = 0.0;
+            }
+        }
+
+        advanceBatch(b, count, counter, minute_share);
+
+        for (std::size_t j = 0; j < count; ++j) {
+            TickerState &s = state_[ids[base + j]];
+            s.price = b.price[j];
+            s.spread = b.spread[j];
+            s.day_open = b.day_open[j];
+            s.day_volume = b.day_volume[j];
+            s.average_volume = b.average_volume[j];
+            s.high = b.high[j];
+            s.low = b.low[j];
+            s.activity = b.activity[j];
+            quotes[base + j] = quoteFor(s);
+        }
+    }
+}
+
+void MarketSimulator::current(std::span<const TickerId> ids, std::span<Quote> quotes) const {
+    if (ids.size() != quotes.size()) {
+        throw std::invalid_argument("MarketSimulator::current: mismatched batch sizes");
+    }
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        quotes[i] = quoteFor(state_[ids[i]]);
+    }
+}
+
+Quote MarketSimulator::quoteFor(const TickerState &s) {
+    Quote q;
+    q.price = s.price;
+    q.market_cap = s.price * s.shares;
+    q.daily_percent_change = (s.price / s.day_open - 1.0) * 100.0;
+    q.volume = static_cast<long long>(s.day_volume);
+    q.average_volume = static_cast<long long>(s.average_volume);
+    q.fiftytwo_week_high = s.high;
+    q.fiftytwo_week_low = s.low;
+    q.bid = s.price - s.spread / 2;
+    q.ask = s.price + s.spread / 2;
+    return q;
+}